@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Background loading pipeline: an Emscripten pthread under -pthread builds,
+// like the threaded reverb worker. The JS main thread queues jobs that do
+// the expensive part of asset loading — the copy, sample-rate conversion
+// and IR segment FFTs — and each job ends by publishing its finished asset
+// to the audio thread through the engine's wait-free ready queue. Loading a
+// preset bank therefore costs the UI thread one submit copy per asset
+// instead of blocking for the whole pipeline, and nothing heavy ever
+// overlaps process(). The worker is spawned lazily on the first submit so
+// builds that never load asynchronously never start a thread.
+class AssetLoader
+{
+public:
+  AssetLoader() = default;
+
+  ~AssetLoader()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_ = false;
+    }
+    cv_.notify_all();
+    if (worker_.joinable())
+      worker_.join();
+  }
+
+  void submit(std::function<void()> job)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!worker_.joinable()) {
+      running_ = true;
+      worker_ = std::thread([this] { run(); });
+    }
+    jobs_.push_back(std::move(job));
+    cv_.notify_one();
+  }
+
+private:
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+      if (jobs_.empty()) {
+        cv_.wait(lock);
+        continue;
+      }
+      std::function<void()> job = std::move(jobs_.front());
+      jobs_.pop_front();
+      lock.unlock();
+      job();
+      lock.lock();
+    }
+  }
+
+  std::deque<std::function<void()>> jobs_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread worker_;
+  bool running_ = false;
+};
@@ -1,16 +1,71 @@
 #include "audio_engine.h"
+#include "resample.h"
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 #include <algorithm>
+#include <chrono>
 #include <cstring>
-#include <emscripten/bind.h>
 
-AudioEngine::AudioEngine() = default;
+namespace {
+
+// steady_clock maps to performance.now() under Emscripten, so the same
+// instrumentation works in the worklet and in the native tools
+inline double
+nowMs()
+{
+  return std::chrono::duration<double, std::milli>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+// Convert an interleaved IR to the engine rate per channel, so a 44.1k IR
+// keeps its decay time and tonal balance under a 48 kHz context. Returns
+// an empty vector (and leaves irLength untouched) when no conversion is
+// needed.
+std::vector<float>
+resampleInterleavedIR(const float* data, size_t& irLength, size_t numChannels,
+                      float sourceRate, float targetRate)
+{
+  std::vector<float> converted;
+  if (sourceRate <= 0.0f || sourceRate == targetRate)
+    return converted;
+
+  std::vector<float> channel(irLength);
+  size_t newLength = 0;
+  for (size_t ch = 0; ch < numChannels; ++ch) {
+    for (size_t i = 0; i < irLength; ++i)
+      channel[i] = data[i * numChannels + ch];
+    std::vector<float> resampled =
+      resampleWindowedSinc(channel.data(), irLength, sourceRate, targetRate);
+    newLength = resampled.size();
+    converted.resize(newLength * numChannels);
+    for (size_t i = 0; i < newLength; ++i)
+      converted[i * numChannels + ch] = resampled[i];
+  }
+  irLength = newLength;
+  return converted;
+}
+
+} // namespace
+
+AudioEngine::AudioEngine()
+{
+  samplePool_.reserve(kSamplePoolFloats);
+  for (auto& voice : kickVoices_)
+    voice.setArena(&samplePool_);
+  noisePlayer_.setArena(&samplePool_);
+}
 
 void
 AudioEngine::prepare(float sampleRate)
 {
   sampleRate_ = sampleRate;
 
-  kickPlayer_.setSampleRate(sampleRate);
+  for (auto& voice : kickVoices_)
+    voice.setSampleRate(sampleRate);
   noisePlayer_.setSampleRate(sampleRate);
   noisePlayer_.setReleaseDuration(0.1f);
   noisePlayer_.setLooping(true);
@@ -34,11 +89,31 @@ AudioEngine::prepare(float sampleRate)
   reverbHighPass_.setType(Filter::Type::highpass);
   reverbHighPass_.setFrequency(30.0f);
 
+  convolution_.prepare(sampleRate);
+#ifndef DSP_THREADED_REVERB
+  // the kick+noise bus feeding the reverb is mono until the stereo IR
+  convolution_.setMonoInput(true);
+#endif
+
   masterOTT_.prepare(sampleRate);
   masterDistortion_.prepare(sampleRate);
   masterLimiter_.prepare(sampleRate);
 
+  meterPeakFall_ = std::exp(-static_cast<float>(kBlockSize) /
+                            (sampleRate * kMeterPeakFallSeconds));
+  meterRmsCoeff_ = std::exp(-static_cast<float>(kBlockSize) /
+                            (sampleRate * kMeterRmsSeconds));
+  meterLevels_.fill(0.0f);
+  meterMeanSq_.fill(0.0f);
+
+  kickCacheCapacity_ = static_cast<int>(sampleRate * kMaxKickCacheSeconds);
+  kickCacheL_.resize(static_cast<size_t>(kickCacheCapacity_));
+  kickCacheR_.resize(kickCacheL_.size());
+  invalidateKickCache();
+
   recalcSamplesPerBeat();
+  scheduler_.setPeriod(samplesPerBeat_,
+                       framesRendered_.load(std::memory_order_relaxed));
 }
 
 void
@@ -47,73 +122,201 @@ AudioEngine::process(uintptr_t leftPtr, uintptr_t rightPtr, int numSamples)
   float* left = reinterpret_cast<float*>(leftPtr);
   float* right = reinterpret_cast<float*>(rightPtr);
 
-  // trigger kick/noise at boundaries
-  if (looping_ && samplesPerBeat_ > 0) {
-    samplesSinceBeat_ += numSamples;
-    while (samplesSinceBeat_ >= samplesPerBeat_) {
-      samplesSinceBeat_ -= samplesPerBeat_;
-      noiseBeatCount_++;
-      kickPlayer_.trigger();
+  double tEnter = nowMs();
 
-      // If new noise selected, trigger it and reset the loop
-      if (pendingNoiseTrigger_) {
-        noisePlayer_.trigger();
-        noiseBeatCount_ = 0;
-        pendingNoiseTrigger_ = false;
-      } else if (noiseBeatCount_ % 16 == 0) {
-        noisePlayer_.trigger();
-      }
+#ifdef DSP_ASYNC_LOADER
+  // adopt finished background loads at the block boundary, ahead of any
+  // queued command that may already reference them
+  ReadyAsset ready;
+  while (readyQueue_.pop(ready))
+    adoptAsset(ready);
+#endif
+
+  // apply parameter changes from the JS thread at the block boundary;
+  // presets ride the same queue, so everything lands in request order
+  Command cmd;
+  while (paramQueue_.pop(cmd))
+    applyCommand(cmd);
+
+  // materialize this block's trigger events; offsets are exact sample
+  // positions within the block, so beats are no longer quantized to the
+  // render quantum
+  const uint64_t blockStart = framesRendered_.load(std::memory_order_relaxed);
+  const uint64_t blockEnd = blockStart + static_cast<uint64_t>(numSamples);
+  std::array<int, kMaxBlockEvents> kickEventOffsets;
+  std::array<int, kMaxBlockEvents> noiseEventOffsets;
+  int numKickEvents = 0;
+  int numNoiseEvents = 0;
+  if (looping_) {
+    scheduler_.fillTo(blockEnd);
+    EventScheduler::Event event;
+    while (scheduler_.pop(blockEnd, event)) {
+      int offset = static_cast<int>(event.frame - blockStart);
+      if (event.type == EventScheduler::Type::kickTrigger &&
+          numKickEvents < kMaxBlockEvents)
+        kickEventOffsets[numKickEvents++] = offset;
+      else if (event.type == EventScheduler::Type::noiseTrigger &&
+               numNoiseEvents < kMaxBlockEvents)
+        noiseEventOffsets[numNoiseEvents++] = offset;
     }
   }
 
-  // kick chain
-  kickPlayer_.process(kickL_.data(), kickR_.data(), numSamples);
+  double tKickStart = nowMs();
+
+  // kick voices summed on the shared bus in runs split at the trigger
+  // offsets; the players always run so their positions stay correct when
+  // a setter invalidates the cache mid-beat and the chain drops back to
+  // live processing
+  int kickRunStart = 0;
+  for (int e = 0; e < numKickEvents; ++e) {
+    const int offset = kickEventOffsets[e];
+    renderKickVoices(kickRunStart, offset);
+    kickRunStart = offset;
+    for (int v = 0; v < kNumKickVoices; ++v)
+      if (kickVoiceActive_[v])
+        kickVoices_[v].trigger();
+
+    // the render cache is keyed off the trigger sample
+    switch (kickCacheState_) {
+      case KickCacheState::invalid:
+        kickCacheSamples_ = 0;
+        kickCaptureOffset_ = offset;
+        kickCacheState_ = KickCacheState::capturing;
+        break;
+      case KickCacheState::capturing:
+        // the kick outlasts the beat, so the chain state at each beat
+        // depends on the previous one; stay live until the next change
+        kickCacheState_ = KickCacheState::bypassed;
+        break;
+      case KickCacheState::valid:
+        // cache sample 0 lands on the trigger sample of this block
+        kickReplayPos_ = -offset;
+        break;
+      case KickCacheState::bypassed:
+        break;
+    }
+  }
+  renderKickVoices(kickRunStart, numSamples);
 
-  if (kickDistortionMix_ > 0.0f) {
-    std::copy_n(kickL_.data(), numSamples, tempL_.data());
-    std::copy_n(kickR_.data(), numSamples, tempR_.data());
-    kickDistortion_.process(kickL_.data(), kickR_.data(), numSamples);
-    float dry = 1.0f - kickDistortionMix_;
-    float wet = kickDistortionMix_;
+  if (looping_ && kickCacheState_ == KickCacheState::valid) {
     for (int i = 0; i < numSamples; ++i) {
-      kickL_[i] = tempL_[i] * dry + kickL_[i] * wet;
-      kickR_[i] = tempR_[i] * dry + kickR_[i] * wet;
+      int idx = kickReplayPos_ + i;
+      bool inCache = idx >= 0 && idx < kickCacheSamples_;
+      kickL_[i] = inCache ? kickCacheL_[idx] : 0.0f;
+      kickR_[i] = inCache ? kickCacheR_[idx] : 0.0f;
+    }
+    kickReplayPos_ += numSamples;
+  } else {
+    if (kickDistortionMix_ > 0.0f) {
+      std::copy_n(kickL_.data(), numSamples, tempL_.data());
+      std::copy_n(kickR_.data(), numSamples, tempR_.data());
+      kickDistortion_.process(kickL_.data(), kickR_.data(), numSamples);
+      float dry = 1.0f - kickDistortionMix_;
+      float wet = kickDistortionMix_;
+      for (int i = 0; i < numSamples; ++i) {
+        kickL_[i] = tempL_[i] * dry + kickL_[i] * wet;
+        kickR_[i] = tempR_[i] * dry + kickR_[i] * wet;
+      }
+    }
+
+    kickOTT_.process(kickL_.data(), kickR_.data(), numSamples);
+
+    if (kickCacheState_ == KickCacheState::capturing) {
+      if (numSamples != kBlockSize) {
+        // partial block (offline render tail): alignment is lost
+        kickCacheState_ = KickCacheState::invalid;
+      } else {
+        float peak = 0.0f;
+        for (int i = 0; i < kBlockSize; ++i)
+          peak = std::max(
+            { peak, std::abs(kickL_[i]), std::abs(kickR_[i]) });
+        int captureLength = kBlockSize - kickCaptureOffset_;
+        if (!anyKickVoicePlaying() && peak < kKickCacheSilence) {
+          // done: replay zeros from here on, including the rest of this
+          // beat
+          kickCacheState_ = KickCacheState::valid;
+          kickReplayPos_ = kickCacheSamples_;
+        } else if (kickCacheSamples_ + captureLength > kickCacheCapacity_) {
+          kickCacheState_ = KickCacheState::bypassed;
+        } else {
+          // the first captured block starts at the trigger offset, so
+          // the cache is aligned to the trigger sample
+          std::copy_n(kickL_.data() + kickCaptureOffset_,
+                      captureLength,
+                      kickCacheL_.data() + kickCacheSamples_);
+          std::copy_n(kickR_.data() + kickCaptureOffset_,
+                      captureLength,
+                      kickCacheR_.data() + kickCacheSamples_);
+          kickCacheSamples_ += captureLength;
+          kickCaptureOffset_ = 0;
+        }
+      }
     }
   }
 
-  kickOTT_.process(kickL_.data(), kickR_.data(), numSamples);
+  meterTap(MeterBus::kick, kickL_.data(), kickR_.data(), numSamples);
+
+  double tNoiseStart = nowMs();
 
-  // noise chain
-  noisePlayer_.process(noiseL_.data(), noiseR_.data(), numSamples);
+  // noise chain, run-split at its trigger offsets like the kick bus
+  int noiseRunStart = 0;
+  for (int e = 0; e < numNoiseEvents; ++e) {
+    const int offset = noiseEventOffsets[e];
+    noisePlayer_.process(noiseL_.data() + noiseRunStart,
+                         noiseR_.data() + noiseRunStart,
+                         offset - noiseRunStart);
+    noisePlayer_.trigger();
+    noiseRunStart = offset;
+  }
+  noisePlayer_.process(noiseL_.data() + noiseRunStart,
+                       noiseR_.data() + noiseRunStart,
+                       numSamples - noiseRunStart);
   noiseLowPass_.process(noiseL_.data(), noiseR_.data(), numSamples);
   noiseHighPass_.process(noiseL_.data(), noiseR_.data(), numSamples);
 
-  // reverb chain
+  double tReverbStart = nowMs();
+
+  // reverb chain: one pass into the reverb bus, convolve, then a single
+  // fused sweep doing low-pass, high-pass, gain and the master-bus sum
+  // per sample instead of five separate passes over the block
   if (activeIRIndex_ >= 0) {
     for (int i = 0; i < numSamples; ++i) {
       reverbL_[i] = kickL_[i] + noiseL_[i];
       reverbR_[i] = kickR_[i] + noiseR_[i];
     }
     convolution_.process(reverbL_.data(), reverbR_.data(), numSamples);
-    reverbLowPass_.process(reverbL_.data(), reverbR_.data(), numSamples);
-    reverbHighPass_.process(reverbL_.data(), reverbR_.data(), numSamples);
     for (int i = 0; i < numSamples; ++i) {
-      reverbL_[i] *= reverbGain_;
-      reverbR_[i] *= reverbGain_;
+      float wetL = reverbHighPass_.processSample(
+        0, reverbLowPass_.processSample(0, reverbL_[i]));
+      float wetR = reverbHighPass_.processSample(
+        1, reverbLowPass_.processSample(1, reverbR_[i]));
+      wetL *= reverbGain_;
+      wetR *= reverbGain_;
+      left[i] = kickL_[i] + noiseL_[i] + wetL;
+      right[i] = kickR_[i] + noiseR_[i] + wetR;
+      // keep the final wet signal around for the meter tap below
+      reverbL_[i] = wetL;
+      reverbR_[i] = wetR;
     }
+    // per-sample filtering bypasses Filter::process and its denormal
+    // squash, so do it here at block rate
+    reverbLowPass_.snapToZero();
+    reverbHighPass_.snapToZero();
+    meterTap(MeterBus::reverb, reverbL_.data(), reverbR_.data(), numSamples);
   } else {
-    std::memset(reverbL_.data(), 0, sizeof(float) * numSamples);
-    std::memset(reverbR_.data(), 0, sizeof(float) * numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+      left[i] = kickL_[i] + noiseL_[i];
+      right[i] = kickR_[i] + noiseR_[i];
+    }
+    meterTap(MeterBus::reverb, nullptr, nullptr, 0);
   }
 
-  // master chain
-  for (int i = 0; i < numSamples; ++i) {
-    left[i] = kickL_[i] + noiseL_[i] + reverbL_[i];
-    right[i] = kickR_[i] + noiseR_[i] + reverbR_[i];
-  }
+  double tMasterOttStart = nowMs();
 
   masterOTT_.process(left, right, numSamples);
 
+  double tMasterOutStart = nowMs();
+
   if (masterDistortionMix_ > 0.0f) {
     std::copy_n(left, numSamples, tempL_.data());
     std::copy_n(right, numSamples, tempR_.data());
@@ -126,123 +329,474 @@ AudioEngine::process(uintptr_t leftPtr, uintptr_t rightPtr, int numSamples)
     }
   }
 
-  for (int i = 0; i < numSamples; ++i) {
-    left[i] *= masterLimiterGain_;
-    right[i] *= masterLimiterGain_;
+  // the limiter applies the drive inside its fused sweep
+  masterLimiter_.process(left, right, numSamples, masterLimiterGain_);
+
+  meterTap(MeterBus::master, left, right, numSamples);
+
+  double tEnd = nowMs();
+
+  float stageMs[kNumTimingStages] = {
+    static_cast<float>(tNoiseStart - tKickStart),
+    static_cast<float>(tReverbStart - tNoiseStart),
+    static_cast<float>(tMasterOttStart - tReverbStart),
+    static_cast<float>(tMasterOutStart - tMasterOttStart),
+    static_cast<float>(tEnd - tMasterOutStart),
+  };
+
+  uint32_t rows = timingRingRows_.load(std::memory_order_relaxed);
+  float* row = timingRing_.data() + (rows % kTimingRingBlocks) * kNumTimingStages;
+  for (int s = 0; s < kNumTimingStages; ++s) {
+    row[s] = stageMs[s];
+    stageMaxMs_[s] = std::max(stageMaxMs_[s], stageMs[s]);
   }
+  timingRingRows_.store(rows + 1, std::memory_order_release);
 
-  masterLimiter_.process(left, right, numSamples);
+  // command drain and transport sit outside the stage rows but inside the
+  // load figure, which tracks the whole callback against its budget
+  float budgetMs = numSamples * 1000.0f / sampleRate_;
+  float load = static_cast<float>(tEnd - tEnter) / budgetMs;
+  if (load > 1.0f)
+    overruns_.fetch_add(1, std::memory_order_relaxed);
+  float smoothed = cpuLoad_.load(std::memory_order_relaxed);
+  smoothed += kCpuLoadSmoothing * (load - smoothed);
+  cpuLoad_.store(smoothed, std::memory_order_relaxed);
+
+  framesRendered_.fetch_add(static_cast<uint64_t>(numSamples),
+                            std::memory_order_relaxed);
+}
+
+void
+AudioEngine::renderOffline(uintptr_t leftPtr, uintptr_t rightPtr,
+                           size_t numSamples)
+{
+  float* left = reinterpret_cast<float*>(leftPtr);
+  float* right = reinterpret_cast<float*>(rightPtr);
+
+  // identical chain and state handling to the worklet path, just without
+  // a JS boundary crossing per render quantum; queued parameter changes
+  // are drained at the first block boundary as usual
+  size_t rendered = 0;
+  while (rendered < numSamples) {
+    size_t remaining = numSamples - rendered;
+    if (remaining >= kBlockSize) {
+      process(reinterpret_cast<uintptr_t>(left + rendered),
+              reinterpret_cast<uintptr_t>(right + rendered),
+              kBlockSize);
+      rendered += kBlockSize;
+    } else {
+      // the chain assumes whole render quanta (the limiter's lookahead
+      // ring exchanges a full block, the kick cache invalidates on short
+      // ones), so a trailing partial request is rendered whole into the
+      // pinned region and trimmed on the way out
+      process(reinterpret_cast<uintptr_t>(pinnedOutL_.data()),
+              reinterpret_cast<uintptr_t>(pinnedOutR_.data()),
+              kBlockSize);
+      std::copy_n(pinnedOutL_.data(), remaining, left + rendered);
+      std::copy_n(pinnedOutR_.data(), remaining, right + rendered);
+      rendered = numSamples;
+    }
+  }
+}
+
+// --- Persistent output buffers ---
+
+uintptr_t
+AudioEngine::getOutputBufferLeft() const
+{
+  return reinterpret_cast<uintptr_t>(pinnedOutL_.data());
+}
+
+uintptr_t
+AudioEngine::getOutputBufferRight() const
+{
+  return reinterpret_cast<uintptr_t>(pinnedOutR_.data());
+}
+
+int
+AudioEngine::getMaxRenderBatch() const
+{
+  return kMaxRenderBatch;
+}
+
+void
+AudioEngine::render(int numBlocks)
+{
+  numBlocks = std::clamp(numBlocks, 1, kMaxRenderBatch);
+  for (int b = 0; b < numBlocks; ++b) {
+    process(reinterpret_cast<uintptr_t>(pinnedOutL_.data() + b * kBlockSize),
+            reinterpret_cast<uintptr_t>(pinnedOutR_.data() + b * kBlockSize),
+            kBlockSize);
+  }
+}
+
+// --- Asset loading ---
+
+SampleArena::Span
+AudioEngine::addToPool(const float* data, size_t length, float sourceRate)
+{
+  if (sourceRate > 0.0f && sourceRate != sampleRate_) {
+    std::vector<float> converted =
+      resampleWindowedSinc(data, length, sourceRate, sampleRate_);
+    return samplePool_.add(converted.data(), converted.size());
+  }
+  return samplePool_.add(data, length);
+}
+
+#ifdef DSP_ASYNC_LOADER
+void
+AudioEngine::adoptAsset(const ReadyAsset& asset)
+{
+  switch (asset.kind) {
+    case ReadyAsset::Kind::kickSample:
+      for (auto& voice : kickVoices_)
+        voice.addSampleSpan(asset.span);
+      break;
+    case ReadyAsset::Kind::noiseSample:
+      noisePlayer_.addSampleSpan(asset.span);
+      break;
+    case ReadyAsset::Kind::ir:
+#ifdef DSP_THREADED_REVERB
+      convolution_.adoptPreparedIR(
+        std::unique_ptr<ThreadedStereoConvolutionReverb::StereoPreparedIR>(
+          asset.ir));
+#else
+      convolution_.adoptPreparedIR(
+        std::unique_ptr<StereoConvolutionReverb::StereoPreparedIR>(asset.ir));
+#endif
+      break;
+  }
+  adoptedLoads_.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+uint32_t
+AudioEngine::getPendingLoads() const
+{
+#ifdef DSP_ASYNC_LOADER
+  return submittedLoads_.load(std::memory_order_relaxed) -
+         adoptedLoads_.load(std::memory_order_relaxed);
+#else
+  return 0;
+#endif
+}
+
+// --- Presets ---
+
+bool
+AudioEngine::applyPreset(uintptr_t ptr, size_t numBytes)
+{
+  if (numBytes != sizeof(EnginePreset))
+    return false;
+
+  EnginePreset preset;
+  std::memcpy(&preset, reinterpret_cast<const void*>(ptr), sizeof(preset));
+  if (std::memcmp(preset.magic, kEnginePresetMagic, 4) != 0 ||
+      preset.version != kEnginePresetVersion)
+    return false;
+
+  uint8_t slot = static_cast<uint8_t>(presetSlotWrite_++ % kNumPresetSlots);
+  presetSlots_[slot] = preset;
+  enqueue(Param::preset, 0.0f, slot);
+  return true;
+}
+
+void
+AudioEngine::applyPresetNow(const EnginePreset& preset)
+{
+  static_assert(kPresetKickVoices == kNumKickVoices,
+                "preset layout must match the voice count");
+
+  // route every field through applyCommand so clamping, cache
+  // invalidation and the noise-swap handshake behave exactly as the
+  // individual setters do
+  Command cmd{ Param::kickLength, 0, 0.0f };
+  auto apply = [&](Param param, float value, uint8_t index) {
+    cmd.param = param;
+    cmd.value = value;
+    cmd.index = index;
+    applyCommand(cmd);
+  };
+
+  for (uint8_t v = 0; v < kNumKickVoices; ++v) {
+    apply(Param::kickVoiceSample,
+          static_cast<float>(preset.kickVoiceSample[v]), v);
+    apply(Param::kickVoiceVolume, preset.kickVoiceVolumeDb[v], v);
+  }
+  apply(Param::kickLength, preset.kickLength, 0);
+  apply(Param::kickDistortion, preset.kickDistortion, 0);
+  apply(Param::kickOTT, preset.kickOTT, 0);
+
+  apply(Param::noiseSample, static_cast<float>(preset.noiseSample), 0);
+  apply(Param::noiseVolume, preset.noiseVolumeDb, 0);
+  apply(Param::noiseLowPass, preset.noiseLowPassHz, 0);
+  apply(Param::noiseHighPass, preset.noiseHighPassHz, 0);
+
+  if (preset.irIndex < 0)
+    activeIRIndex_ = -1; // selectIR has no off position, presets do
+  else
+    apply(Param::irIndex, static_cast<float>(preset.irIndex), 0);
+  shadowPreset_.irIndex = activeIRIndex_; // reflects a rejected index too
+  apply(Param::reverbLowPass, preset.reverbLowPassHz, 0);
+  apply(Param::reverbHighPass, preset.reverbHighPassHz, 0);
+  apply(Param::reverbVolume, preset.reverbVolumeDb, 0);
+
+  apply(Param::masterOTT, preset.masterOTT, 0);
+  apply(Param::masterDistortion, preset.masterDistortion, 0);
+  apply(Param::masterLimiter, preset.masterLimiter, 0);
+}
+
+uintptr_t
+AudioEngine::capturePreset()
+{
+  presetOut_ = shadowPreset_;
+  return reinterpret_cast<uintptr_t>(&presetOut_);
+}
+
+size_t
+AudioEngine::getPresetSize() const
+{
+  return sizeof(EnginePreset);
 }
 
 // --- Kick ---
 
 void
-AudioEngine::loadKickSample(uintptr_t ptr, size_t length)
+AudioEngine::loadKickSample(uintptr_t ptr, size_t length, float sourceRate)
 {
-  kickPlayer_.loadSample(ptr, length);
+  // one arena copy (resampled to the engine rate if the asset rate
+  // differs); every voice references the same span
+  const float* data = reinterpret_cast<const float*>(ptr);
+#ifdef DSP_ASYNC_LOADER
+  submittedLoads_.fetch_add(1, std::memory_order_relaxed);
+  std::vector<float> pcm(data, data + length);
+  loader_.submit([this, pcm = std::move(pcm), sourceRate] {
+    ReadyAsset asset;
+    asset.kind = ReadyAsset::Kind::kickSample;
+    asset.span = addToPool(pcm.data(), pcm.size(), sourceRate);
+    readyQueue_.push(asset);
+  });
+#else
+  SampleArena::Span span = addToPool(data, length, sourceRate);
+  for (auto& voice : kickVoices_)
+    voice.addSampleSpan(span);
+#endif
 }
 
 void
 AudioEngine::selectKickSample(int index)
 {
-  kickPlayer_.selectSample(index);
+  enqueue(Param::kickSample, static_cast<float>(index));
+}
+
+void
+AudioEngine::setKickVoiceSample(int voice, int index)
+{
+  if (voice < 0 || voice >= kNumKickVoices)
+    return;
+  enqueue(Param::kickVoiceSample,
+          static_cast<float>(index),
+          static_cast<uint8_t>(voice));
+}
+
+void
+AudioEngine::setKickVoiceVolume(int voice, float db)
+{
+  if (voice < 0 || voice >= kNumKickVoices)
+    return;
+  enqueue(Param::kickVoiceVolume, db, static_cast<uint8_t>(voice));
+}
+
+int
+AudioEngine::getNumKickVoices() const
+{
+  return kNumKickVoices;
+}
+
+bool
+AudioEngine::anyKickVoicePlaying() const
+{
+  for (int v = 0; v < kNumKickVoices; ++v)
+    if (kickVoiceActive_[v] && kickVoices_[v].isPlaying())
+      return true;
+  return false;
+}
+
+void
+AudioEngine::renderKickVoices(int start, int end)
+{
+  const int numSamples = end - start;
+  if (numSamples <= 0)
+    return;
+  bool firstVoice = true;
+  for (int v = 0; v < kNumKickVoices; ++v) {
+    if (!kickVoiceActive_[v])
+      continue;
+    if (firstVoice) {
+      kickVoices_[v].process(kickL_.data() + start,
+                             kickR_.data() + start,
+                             numSamples);
+      firstVoice = false;
+    } else {
+      kickVoices_[v].process(tempL_.data(), tempR_.data(), numSamples);
+      for (int i = 0; i < numSamples; ++i) {
+        kickL_[start + i] += tempL_[i];
+        kickR_[start + i] += tempR_[i];
+      }
+    }
+  }
+  if (firstVoice) {
+    std::fill_n(kickL_.data() + start, numSamples, 0.0f);
+    std::fill_n(kickR_.data() + start, numSamples, 0.0f);
+  }
 }
 
 void
 AudioEngine::setKickLength(float ratio)
 {
-  kickPlayer_.setLengthRatio(ratio);
+  enqueue(Param::kickLength, ratio);
 }
 
 void
 AudioEngine::setKickDistortion(float amount)
 {
-  kickDistortionMix_ = std::clamp(amount, 0.0f, 1.0f);
+  enqueue(Param::kickDistortion, amount);
 }
 
 void
 AudioEngine::setKickOTT(float amount)
 {
-  kickOTT_.setAmount(std::clamp(amount, 0.0f, 1.0f));
+  enqueue(Param::kickOTT, amount);
+}
+
+void
+AudioEngine::clearSamples()
+{
+  for (auto& voice : kickVoices_)
+    voice.clearSamples();
+  noisePlayer_.clearSamples();
+  samplePool_.clear();
+  invalidateKickCache();
 }
 
 // --- Noise ---
 
 void
-AudioEngine::loadNoiseSample(uintptr_t ptr, size_t length)
+AudioEngine::loadNoiseSample(uintptr_t ptr, size_t length, float sourceRate)
 {
-  noisePlayer_.loadSample(ptr, length);
+  const float* data = reinterpret_cast<const float*>(ptr);
+#ifdef DSP_ASYNC_LOADER
+  submittedLoads_.fetch_add(1, std::memory_order_relaxed);
+  std::vector<float> pcm(data, data + length);
+  loader_.submit([this, pcm = std::move(pcm), sourceRate] {
+    ReadyAsset asset;
+    asset.kind = ReadyAsset::Kind::noiseSample;
+    asset.span = addToPool(pcm.data(), pcm.size(), sourceRate);
+    readyQueue_.push(asset);
+  });
+#else
+  // the noise player shares the pool, so this is the same arena add
+  noisePlayer_.addSampleSpan(addToPool(data, length, sourceRate));
+#endif
 }
 
 void
 AudioEngine::selectNoiseSample(int index)
 {
-  noisePlayer_.selectSample(index);
-  if (looping_) {
-    pendingNoiseTrigger_ = true;
-  }
+  enqueue(Param::noiseSample, static_cast<float>(index));
 }
 
 void
 AudioEngine::setNoiseVolume(float db)
 {
-  // translate from db to linear number that can be multiplied onto signal
-  noisePlayer_.setVolume(std::pow(10.0f, db / 20.0f));
+  enqueue(Param::noiseVolume, db);
 }
 
 void
 AudioEngine::setNoiseLowPass(float hz)
 {
-  noiseLowPass_.setFrequency(hz);
+  enqueue(Param::noiseLowPass, hz);
 }
 
 void
 AudioEngine::setNoiseHighPass(float hz)
 {
-  noiseHighPass_.setFrequency(hz);
+  enqueue(Param::noiseHighPass, hz);
 }
 
 // --- Reverb ---
 
 void
-AudioEngine::loadIR(uintptr_t ptr, size_t irLength, size_t numChannels)
+AudioEngine::loadIR(uintptr_t ptr, size_t irLength, size_t numChannels,
+                    float sourceRate)
 {
   const float* data = reinterpret_cast<const float*>(ptr);
-  size_t totalSamples = irLength * numChannels;
-  IRData ir;
-  ir.samples.assign(data, data + totalSamples);
-  ir.lengthPerChannel = irLength;
-  ir.numChannels = static_cast<int>(numChannels);
-  irStorage_.push_back(std::move(ir));
+#ifdef DSP_ASYNC_LOADER
+  submittedLoads_.fetch_add(1, std::memory_order_relaxed);
+  std::vector<float> pcm(data, data + irLength * numChannels);
+  loader_.submit([this, pcm = std::move(pcm), irLength, numChannels,
+                  sourceRate] {
+    size_t length = irLength;
+    std::vector<float> converted = resampleInterleavedIR(
+      pcm.data(), length, numChannels, sourceRate, sampleRate_);
+    const float* src = converted.empty() ? pcm.data() : converted.data();
+
+    ReadyAsset asset;
+    asset.kind = ReadyAsset::Kind::ir;
+    asset.ir =
+      convolution_.buildPreparedIR(src, length, static_cast<int>(numChannels))
+        .release();
+    readyQueue_.push(asset);
+  });
+#else
+  size_t length = irLength;
+  std::vector<float> converted = resampleInterleavedIR(
+    data, length, numChannels, sourceRate, sampleRate_);
+  const float* src = converted.empty() ? data : converted.data();
+
+  // FFT the IR once up front; selectIR is then just a pointer swap
+  convolution_.addPreparedIR(src, length, static_cast<int>(numChannels));
+#endif
+}
+
+void
+AudioEngine::loadPreparedIR(uintptr_t ptr, size_t numBytes)
+{
+#ifndef DSP_THREADED_REVERB
+  // offline-prepared "KIR1" blob (ir_file.h): ingested with one copy and
+  // no FFT work, unlike loadIR which transforms every segment here
+  const void* data = reinterpret_cast<const void*>(ptr);
+  convolution_.addPreparedIRFile(data, numBytes);
+#else
+  // the KIR1 layout matches the sync engine's non-uniform partitioning,
+  // not the threaded build's early/late hop; use loadIR there
+  (void)ptr;
+  (void)numBytes;
+#endif
 }
 
 void
 AudioEngine::selectIR(int index)
 {
-  if (index >= 0 && index < static_cast<int>(irStorage_.size()) &&
-      index != activeIRIndex_) {
-    activeIRIndex_ = index;
-    const auto& ir = irStorage_[index];
-    convolution_.loadIR(ir.samples.data(), ir.lengthPerChannel, ir.numChannels);
-  }
+  enqueue(Param::irIndex, static_cast<float>(index));
 }
 
 void
 AudioEngine::setReverbLowPass(float hz)
 {
-  reverbLowPass_.setFrequency(hz);
+  enqueue(Param::reverbLowPass, hz);
 }
 
 void
 AudioEngine::setReverbHighPass(float hz)
 {
-  reverbHighPass_.setFrequency(hz);
+  enqueue(Param::reverbHighPass, hz);
 }
 
 void
 AudioEngine::setReverbVolume(float db)
 {
-  reverbGain_ = std::pow(10.0f, db / 20.0f);
+  enqueue(Param::reverbVolume, db);
 }
 
 // --- Master ---
@@ -250,19 +804,19 @@ AudioEngine::setReverbVolume(float db)
 void
 AudioEngine::setMasterOTT(float amount)
 {
-  masterOTT_.setAmount(std::clamp(amount, 0.0f, 1.0f));
+  enqueue(Param::masterOTT, amount);
 }
 
 void
 AudioEngine::setMasterDistortion(float amount)
 {
-  masterDistortionMix_ = std::clamp(amount, 0.0f, 1.0f);
+  enqueue(Param::masterDistortion, amount);
 }
 
 void
 AudioEngine::setMasterLimiter(float amount)
 {
-  masterLimiterGain_ = std::clamp(amount, 1.0f, 8.0f);
+  enqueue(Param::masterLimiter, amount);
 }
 
 // --- Transport ---
@@ -270,30 +824,19 @@ AudioEngine::setMasterLimiter(float amount)
 void
 AudioEngine::setLooping(bool enabled)
 {
-  looping_ = enabled;
-  if (enabled) {
-    samplesSinceBeat_ = 0;
-    noiseBeatCount_ = 0;
-    kickPlayer_.trigger();
-    noisePlayer_.trigger();
-  } else {
-    noisePlayer_.stop();
-  }
+  enqueue(Param::looping, enabled ? 1.0f : 0.0f);
 }
 
 void
 AudioEngine::cue()
 {
-  noisePlayer_.setLooping(false);
-  noisePlayer_.trigger();
-  kickPlayer_.trigger();
+  enqueue(Param::cue, 0.0f);
 }
 
 void
 AudioEngine::cueRelease()
 {
-  noisePlayer_.stop();
-  noisePlayer_.setLooping(true);
+  enqueue(Param::cueRelease, 0.0f);
 }
 
 void
@@ -307,43 +850,269 @@ AudioEngine::recalcSamplesPerBeat()
 void
 AudioEngine::setBPM(float bpm)
 {
-  bpm_ = bpm;
-  recalcSamplesPerBeat();
+  enqueue(Param::bpm, bpm);
+}
+
+// --- CPU instrumentation ---
+
+float
+AudioEngine::getCpuLoad() const
+{
+  return cpuLoad_.load(std::memory_order_relaxed);
+}
+
+uintptr_t
+AudioEngine::getStageTimings() const
+{
+  return reinterpret_cast<uintptr_t>(timingRing_.data());
+}
+
+uint32_t
+AudioEngine::getTimingRingPosition() const
+{
+  return timingRingRows_.load(std::memory_order_acquire);
+}
+
+uintptr_t
+AudioEngine::getStageMaxTimings() const
+{
+  return reinterpret_cast<uintptr_t>(stageMaxMs_.data());
+}
+
+uint32_t
+AudioEngine::getOverrunCount() const
+{
+  return overruns_.load(std::memory_order_relaxed);
+}
+
+void
+AudioEngine::resetCpuStats()
+{
+  stageMaxMs_.fill(0.0f);
+  overruns_.store(0, std::memory_order_relaxed);
+  cpuLoad_.store(0.0f, std::memory_order_relaxed);
+}
+
+int
+AudioEngine::getNumTimingStages() const
+{
+  return kNumTimingStages;
+}
+
+int
+AudioEngine::getTimingRingBlocks() const
+{
+  return kTimingRingBlocks;
 }
 
-// --- Emscripten bindings ---
-
-EMSCRIPTEN_BINDINGS(audio_module)
-{
-  emscripten::class_<AudioEngine>("AudioEngine")
-    .constructor()
-    .function("prepare", &AudioEngine::prepare)
-    .function("process", &AudioEngine::process)
-    // Kick
-    .function("loadKickSample", &AudioEngine::loadKickSample)
-    .function("selectKickSample", &AudioEngine::selectKickSample)
-    .function("setKickLength", &AudioEngine::setKickLength)
-    .function("setKickDistortion", &AudioEngine::setKickDistortion)
-    .function("setKickOTT", &AudioEngine::setKickOTT)
-    // Noise
-    .function("loadNoiseSample", &AudioEngine::loadNoiseSample)
-    .function("selectNoiseSample", &AudioEngine::selectNoiseSample)
-    .function("setNoiseVolume", &AudioEngine::setNoiseVolume)
-    .function("setNoiseLowPass", &AudioEngine::setNoiseLowPass)
-    .function("setNoiseHighPass", &AudioEngine::setNoiseHighPass)
-    // Reverb
-    .function("loadIR", &AudioEngine::loadIR)
-    .function("selectIR", &AudioEngine::selectIR)
-    .function("setReverbLowPass", &AudioEngine::setReverbLowPass)
-    .function("setReverbHighPass", &AudioEngine::setReverbHighPass)
-    .function("setReverbVolume", &AudioEngine::setReverbVolume)
-    // Master
-    .function("setMasterOTT", &AudioEngine::setMasterOTT)
-    .function("setMasterDistortion", &AudioEngine::setMasterDistortion)
-    .function("setMasterLimiter", &AudioEngine::setMasterLimiter)
-    // Transport
-    .function("setBPM", &AudioEngine::setBPM)
-    .function("setLooping", &AudioEngine::setLooping)
-    .function("cue", &AudioEngine::cue)
-    .function("cueRelease", &AudioEngine::cueRelease);
+// --- Metering ---
+
+void
+AudioEngine::meterTap(MeterBus bus, const float* left, const float* right,
+                      int numSamples)
+{
+  // peak and sum of squares across both channels, scanned 4-wide like the
+  // limiter's peak pass
+  float peak = 0.0f;
+  float sumSq = 0.0f;
+  int i = 0;
+#if defined(__wasm_simd128__)
+  if (numSamples >= 4) {
+    v128_t vpeak = wasm_f32x4_splat(0.0f);
+    v128_t vsum = wasm_f32x4_splat(0.0f);
+    for (; i + 4 <= numSamples; i += 4) {
+      v128_t l = wasm_v128_load(left + i);
+      v128_t r = wasm_v128_load(right + i);
+      vpeak = wasm_f32x4_pmax(
+        vpeak, wasm_f32x4_pmax(wasm_f32x4_abs(l), wasm_f32x4_abs(r)));
+      vsum = wasm_f32x4_add(
+        vsum, wasm_f32x4_add(wasm_f32x4_mul(l, l), wasm_f32x4_mul(r, r)));
+    }
+    vpeak =
+      wasm_f32x4_pmax(vpeak, wasm_i32x4_shuffle(vpeak, vpeak, 2, 3, 0, 1));
+    vpeak =
+      wasm_f32x4_pmax(vpeak, wasm_i32x4_shuffle(vpeak, vpeak, 1, 0, 3, 2));
+    peak = wasm_f32x4_extract_lane(vpeak, 0);
+    vsum = wasm_f32x4_add(vsum, wasm_i32x4_shuffle(vsum, vsum, 2, 3, 0, 1));
+    vsum = wasm_f32x4_add(vsum, wasm_i32x4_shuffle(vsum, vsum, 1, 0, 3, 2));
+    sumSq = wasm_f32x4_extract_lane(vsum, 0);
+  }
+#endif
+  for (; i < numSamples; ++i) {
+    peak = std::max({ peak, std::abs(left[i]), std::abs(right[i]) });
+    sumSq += left[i] * left[i] + right[i] * right[i];
+  }
+
+  const int b = static_cast<int>(bus);
+  float* slot = meterLevels_.data() + b * 2;
+  slot[0] = std::max(peak, slot[0] * meterPeakFall_);
+
+  // smooth the mean square, not the root, so decays read linearly in power
+  float meanSq = numSamples > 0
+                   ? sumSq / static_cast<float>(2 * numSamples)
+                   : 0.0f;
+  meterMeanSq_[b] = meanSq + (meterMeanSq_[b] - meanSq) * meterRmsCoeff_;
+  slot[1] = std::sqrt(meterMeanSq_[b]);
+}
+
+uintptr_t
+AudioEngine::getMeterLevels() const
+{
+  return reinterpret_cast<uintptr_t>(meterLevels_.data());
+}
+
+int
+AudioEngine::getNumMeterBuses() const
+{
+  return kNumMeterBuses;
+}
+
+// --- Command queue ---
+
+void
+AudioEngine::enqueue(Param param, float value, uint8_t index)
+{
+  Command cmd{ param, index, value };
+  // dropped on the floor if the queue is full; 256 pending changes means
+  // the worklet has stalled and parameter accuracy is the least concern
+  paramQueue_.push(cmd);
+}
+
+void
+AudioEngine::applyCommand(const Command& cmd)
+{
+  switch (cmd.param) {
+    case Param::kickSample:
+      kickVoices_[0].selectSample(static_cast<int>(cmd.value));
+      shadowPreset_.kickVoiceSample[0] = static_cast<int32_t>(cmd.value);
+      invalidateKickCache();
+      break;
+    case Param::kickVoiceSample: {
+      int index = static_cast<int>(cmd.value);
+      if (index < 0) {
+        kickVoiceActive_[cmd.index] = false;
+      } else {
+        kickVoices_[cmd.index].selectSample(index);
+        kickVoiceActive_[cmd.index] = true;
+      }
+      shadowPreset_.kickVoiceSample[cmd.index] = index;
+      invalidateKickCache();
+      break;
+    }
+    case Param::kickVoiceVolume:
+      kickVoices_[cmd.index].setVolume(std::pow(10.0f, cmd.value / 20.0f));
+      shadowPreset_.kickVoiceVolumeDb[cmd.index] = cmd.value;
+      invalidateKickCache();
+      break;
+    case Param::kickLength:
+      for (auto& voice : kickVoices_)
+        voice.setLengthRatio(cmd.value);
+      shadowPreset_.kickLength = cmd.value;
+      invalidateKickCache();
+      break;
+    case Param::kickDistortion:
+      kickDistortionMix_ = std::clamp(cmd.value, 0.0f, 1.0f);
+      shadowPreset_.kickDistortion = kickDistortionMix_;
+      invalidateKickCache();
+      break;
+    case Param::kickOTT:
+      kickOTT_.setAmount(std::clamp(cmd.value, 0.0f, 1.0f));
+      shadowPreset_.kickOTT = std::clamp(cmd.value, 0.0f, 1.0f);
+      invalidateKickCache();
+      break;
+    case Param::noiseSample:
+      noisePlayer_.selectSample(static_cast<int>(cmd.value));
+      shadowPreset_.noiseSample = static_cast<int32_t>(cmd.value);
+      if (looping_) {
+        scheduler_.requestNoiseSwap();
+      }
+      break;
+    case Param::noiseVolume:
+      // translate from db to linear number that can be multiplied onto signal
+      noisePlayer_.setVolume(std::pow(10.0f, cmd.value / 20.0f));
+      shadowPreset_.noiseVolumeDb = cmd.value;
+      break;
+    case Param::noiseLowPass:
+      noiseLowPass_.setFrequency(cmd.value);
+      shadowPreset_.noiseLowPassHz = cmd.value;
+      break;
+    case Param::noiseHighPass:
+      noiseHighPass_.setFrequency(cmd.value);
+      shadowPreset_.noiseHighPassHz = cmd.value;
+      break;
+    case Param::irIndex: {
+      int index = static_cast<int>(cmd.value);
+      if (index >= 0 &&
+          index < static_cast<int>(convolution_.numPreparedIRs()) &&
+          index != activeIRIndex_) {
+        activeIRIndex_ = index;
+        convolution_.selectPreparedIR(static_cast<size_t>(index));
+        shadowPreset_.irIndex = index;
+      }
+      break;
+    }
+    case Param::reverbLowPass:
+      reverbLowPass_.setFrequency(cmd.value);
+      shadowPreset_.reverbLowPassHz = cmd.value;
+      break;
+    case Param::reverbHighPass:
+      reverbHighPass_.setFrequency(cmd.value);
+      shadowPreset_.reverbHighPassHz = cmd.value;
+      break;
+    case Param::reverbVolume:
+      reverbGain_ = std::pow(10.0f, cmd.value / 20.0f);
+      shadowPreset_.reverbVolumeDb = cmd.value;
+      break;
+    case Param::masterOTT:
+      masterOTT_.setAmount(std::clamp(cmd.value, 0.0f, 1.0f));
+      shadowPreset_.masterOTT = std::clamp(cmd.value, 0.0f, 1.0f);
+      break;
+    case Param::masterDistortion:
+      masterDistortionMix_ = std::clamp(cmd.value, 0.0f, 1.0f);
+      shadowPreset_.masterDistortion = masterDistortionMix_;
+      break;
+    case Param::masterLimiter:
+      masterLimiterGain_ = std::clamp(cmd.value, 1.0f, 8.0f);
+      shadowPreset_.masterLimiter = masterLimiterGain_;
+      break;
+    case Param::bpm:
+      bpm_ = cmd.value;
+      recalcSamplesPerBeat();
+      scheduler_.setPeriod(samplesPerBeat_,
+                           framesRendered_.load(std::memory_order_relaxed));
+      invalidateKickCache();
+      break;
+    case Param::looping:
+      looping_ = cmd.value != 0.0f;
+      invalidateKickCache();
+      if (looping_) {
+        // beat 0 fires here; the scheduler takes over from beat 1
+        scheduler_.start(framesRendered_.load(std::memory_order_relaxed),
+                         samplesPerBeat_);
+        for (int v = 0; v < kNumKickVoices; ++v)
+          if (kickVoiceActive_[v])
+            kickVoices_[v].trigger();
+        noisePlayer_.trigger();
+      } else {
+        scheduler_.stop();
+        noisePlayer_.stop();
+      }
+      break;
+    case Param::cue:
+      noisePlayer_.setLooping(false);
+      noisePlayer_.trigger();
+      for (int v = 0; v < kNumKickVoices; ++v)
+        if (kickVoiceActive_[v])
+          kickVoices_[v].trigger();
+      // a cue mid-loop retriggers the kick off the beat grid
+      invalidateKickCache();
+      break;
+    case Param::cueRelease:
+      noisePlayer_.stop();
+      noisePlayer_.setLooping(true);
+      break;
+    case Param::preset:
+      applyPresetNow(presetSlots_[cmd.index]);
+      break;
+  }
 }
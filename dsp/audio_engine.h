@@ -1,13 +1,25 @@
 #pragma once
 
+#ifdef DSP_ASYNC_LOADER
+#include "asset_loader.h"
+#endif
+#include "command_queue.h"
 #include "convolution.h"
+#include "dsp_config.h"
+#ifdef DSP_THREADED_REVERB
+#include "convolution-mt.h"
+#endif
 #include "distortion.h"
+#include "event_scheduler.h"
 #include "filter.h"
 #include "limiter.h"
 #include "ott.h"
+#include "preset.h"
+#include "sample_arena.h"
 #include "sample_player.h"
 
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <vector>
@@ -20,22 +32,74 @@ public:
   void prepare(float sampleRate);
   void process(uintptr_t leftPtr, uintptr_t rightPtr, int numSamples);
 
-  // Kick
-  void loadKickSample(uintptr_t ptr, size_t length);
+  // Run the full chain into preallocated heap buffers in one call, as
+  // fast as the CPU allows — for WAV export without playing out in real
+  // time. Synchronous; call from a worker to keep it off the UI thread.
+  void renderOffline(uintptr_t leftPtr, uintptr_t rightPtr,
+                     size_t numSamples);
+
+  // Persistent output region: instead of marshalling fresh heap pointers
+  // (and copying audio across the JS boundary) 344 times a second, the
+  // worklet fetches these offsets once and reads the rendered quanta
+  // straight out of a HEAPF32 view. render(n) fills n consecutive blocks
+  // (1..getMaxRenderBatch()) per call for worklets that batch quanta.
+  uintptr_t getOutputBufferLeft() const;
+  uintptr_t getOutputBufferRight() const;
+  int getMaxRenderBatch() const;
+  void render(int numBlocks);
+
+  // Kick. Up to kNumKickVoices layers play from one shared sample bank
+  // and sum on a bus that runs the kick effects once; loadKickSample adds
+  // to the bank, selectKickSample keeps addressing voice 0. The load
+  // functions take the asset's native rate and convert once to the
+  // prepare() rate (0 = already at the engine rate), so a 44.1k kick
+  // stays in tune under a 48 kHz AudioContext with no per-sample
+  // interpolation at play time. Call prepare before loading.
+  void loadKickSample(uintptr_t ptr, size_t length, float sourceRate = 0.0f);
   void selectKickSample(int index);
+  void setKickVoiceSample(int voice, int index); // index -1 mutes the voice
+  void setKickVoiceVolume(int voice, float db);
   void setKickLength(float ratio);
   void setKickDistortion(float amount);
   void setKickOTT(float amount);
+  int getNumKickVoices() const;
+
+  // Evict every loaded sample and reclaim the pool for a new preset bank;
+  // call with playback stopped, like the load functions
+  void clearSamples();
+
+  // Under the async-loader build the load functions return immediately and
+  // the copy/SRC/FFT work runs on a background worker; finished assets are
+  // adopted by the audio thread at the next block boundary, in submission
+  // order, so cache indices still match call order. Poll this until it
+  // returns 0 before selecting freshly loaded assets (it only drains while
+  // blocks are being rendered). Synchronous builds always return 0.
+  uint32_t getPendingLoads() const;
+
+  // Preset snapshots. applyPreset ingests a packed EnginePreset (see
+  // preset.h) and applies every field in one pass at the next block
+  // boundary, so a preset switch is a single boundary crossing instead of
+  // ~20 embind setter calls each racing its own block; returns false if
+  // the blob is not a valid preset. Presets and individual setters are
+  // applied strictly in call order. capturePreset writes the currently
+  // applied values into a pinned struct and returns its offset for a
+  // HEAPU8 copy of getPresetSize() bytes; capture while no changes are in
+  // flight, as a racing setter can land between fields.
+  bool applyPreset(uintptr_t ptr, size_t numBytes);
+  uintptr_t capturePreset();
+  size_t getPresetSize() const;
 
   // Noise
-  void loadNoiseSample(uintptr_t ptr, size_t length);
+  void loadNoiseSample(uintptr_t ptr, size_t length, float sourceRate = 0.0f);
   void selectNoiseSample(int index);
   void setNoiseVolume(float db);
   void setNoiseLowPass(float hz);
   void setNoiseHighPass(float hz);
 
   // Reverb
-  void loadIR(uintptr_t ptr, size_t irLength, size_t numChannels);
+  void loadIR(uintptr_t ptr, size_t irLength, size_t numChannels,
+              float sourceRate = 0.0f);
+  void loadPreparedIR(uintptr_t ptr, size_t numBytes);
   void selectIR(int index);
   void setReverbLowPass(float hz);
   void setReverbHighPass(float hz);
@@ -52,8 +116,136 @@ public:
   void cue();
   void cueRelease();
 
+  // CPU instrumentation. The frontend polls these through a HEAPF32 view
+  // on the returned pointers, so a meter refresh allocates nothing; see
+  // timingRing_ below for the layout.
+  float getCpuLoad() const;              // smoothed block time / budget
+  uintptr_t getStageTimings() const;     // ring of per-stage ms rows
+  uint32_t getTimingRingPosition() const; // rows written so far
+  uintptr_t getStageMaxTimings() const;  // running per-stage max, in ms
+  uint32_t getOverrunCount() const;      // blocks that blew the budget
+  void resetCpuStats();
+  int getNumTimingStages() const;
+  int getTimingRingBlocks() const;
+
+  // Bus metering: [peak, rms] float pairs for the kick bus, the reverb wet
+  // bus and the master output, in that order, refreshed every block inside
+  // process(). The frontend reads them through a HEAPF32 view on the
+  // returned offset — no AnalyserNode tap, no copy of the signal back to
+  // JS, and per-bus levels the output tap can't see. Peaks fall at a fixed
+  // rate between hits; RMS is smoothed over ~50 ms.
+  uintptr_t getMeterLevels() const;
+  int getNumMeterBuses() const;
+
 private:
-  static constexpr int kBlockSize = 128;
+  static constexpr int kBlockSize = kRenderBlockSize;
+
+  // Setters run on the JS main thread while process() runs in the worklet;
+  // every state change travels through a wait-free queue and is applied at
+  // the next block boundary instead of mutating engine state mid-block
+  enum class Param : uint8_t
+  {
+    kickSample,
+    kickVoiceSample,
+    kickVoiceVolume,
+    kickLength,
+    kickDistortion,
+    kickOTT,
+    noiseSample,
+    noiseVolume,
+    noiseLowPass,
+    noiseHighPass,
+    irIndex,
+    reverbLowPass,
+    reverbHighPass,
+    reverbVolume,
+    masterOTT,
+    masterDistortion,
+    masterLimiter,
+    bpm,
+    looping,
+    cue,
+    cueRelease,
+    preset, // whole EnginePreset; index names the slot in presetSlots_
+  };
+
+  struct Command
+  {
+    Param param;
+    uint8_t index; // voice number for the per-voice params
+    float value;
+  };
+
+  void enqueue(Param param, float value, uint8_t index = 0);
+  void applyCommand(const Command& cmd);
+
+  // Copy (and resample, when sourceRate differs) PCM into the shared pool
+  SampleArena::Span addToPool(const float* data, size_t length,
+                              float sourceRate);
+
+#ifdef DSP_ASYNC_LOADER
+  // A finished background load, handed from the worker to the audio
+  // thread through readyQueue_; the heavy work is done, adoption is a
+  // span/pointer installation
+  struct ReadyAsset
+  {
+    enum class Kind : uint8_t
+    {
+      kickSample,
+      noiseSample,
+      ir,
+    };
+
+    Kind kind = Kind::kickSample;
+    SampleArena::Span span;
+#ifdef DSP_THREADED_REVERB
+    ThreadedStereoConvolutionReverb::StereoPreparedIR* ir = nullptr; // owned
+#else
+    StereoConvolutionReverb::StereoPreparedIR* ir = nullptr; // owned
+#endif
+  };
+
+  void adoptAsset(const ReadyAsset& asset);
+
+  AssetLoader loader_;
+  CommandQueue<ReadyAsset, 64> readyQueue_;
+  std::atomic<uint32_t> submittedLoads_{ 0 };
+  std::atomic<uint32_t> adoptedLoads_{ 0 };
+#endif
+
+  // While looping, the kick -> distortion -> OTT output is the same every
+  // beat until a kick-chain setter changes something. The first beat after
+  // a change is rendered live and captured; later beats replay the capture
+  // with a copy and skip the distortion/OTT work entirely. bypassed means
+  // the kick outlasts the beat (chain state then carries across beats) and
+  // caching stays off until the next parameter change.
+  enum class KickCacheState : uint8_t
+  {
+    invalid,
+    capturing,
+    valid,
+    bypassed,
+  };
+
+  void invalidateKickCache() { kickCacheState_ = KickCacheState::invalid; }
+
+  CommandQueue<Command, 256> paramQueue_;
+  std::atomic<uint64_t> framesRendered_{ 0 };
+
+  // Presets ride paramQueue_ like any setter, so application follows
+  // request order exactly: a setter enqueued before applyPreset in the
+  // same block is overridden by the preset, one enqueued after it wins.
+  // The 96-byte blob does not fit a Command, so it is parked in a small
+  // slot ring and the command carries the slot index; more pending
+  // presets than slots reuse the oldest slot, which at worst re-applies
+  // the newest snapshot. shadowPreset_ tracks the applied values (updated
+  // only on the audio thread) and backs capturePreset.
+  void applyPresetNow(const EnginePreset& preset);
+  static constexpr size_t kNumPresetSlots = 4;
+  std::array<EnginePreset, kNumPresetSlots> presetSlots_;
+  uint32_t presetSlotWrite_ = 0; // JS thread only
+  EnginePreset shadowPreset_;
+  EnginePreset presetOut_;
 
   // kick OTT boosts the lows and ratios a bit more than the master
   static constexpr float kKickOttRatioMultiplier = 10.0f;
@@ -68,10 +260,24 @@ private:
 
   float sampleRate_ = 44100.0f;
 
-  // Players
-  SamplePlayer kickPlayer_;
+  // Both players place their samples in one preallocated slab, so loading
+  // a preset bank is a sequence of copies rather than per-sample heap
+  // growth (sized for ~30 presets of mono kick + noise PCM at 48 kHz)
+  static constexpr size_t kSamplePoolFloats = 4u * 1024 * 1024; // 16 MiB
+  SampleArena samplePool_;
+
+  // Kick voices (layers): each is a full SamplePlayer, summed on the kick
+  // bus before the effects, so several layers cost one effect chain. Only
+  // voice 0 is active until the frontend assigns samples to the others.
+  static constexpr int kNumKickVoices = 4;
+  std::array<SamplePlayer, kNumKickVoices> kickVoices_;
+  std::array<bool, kNumKickVoices> kickVoiceActive_{ true, false, false,
+                                                     false };
+
   SamplePlayer noisePlayer_;
 
+  bool anyKickVoicePlaying() const;
+
   // Kick effects
   Distortion kickDistortion_;
   OTTCompressor kickOTT_{ kKickOttRatioMultiplier,
@@ -84,20 +290,18 @@ private:
   Filter noiseLowPass_;
   Filter noiseHighPass_;
 
-  // Reverb
+  // Reverb; the threaded variant convolves the early segment in sync and
+  // runs the late tail on a background pthread
+#ifdef DSP_THREADED_REVERB
+  ThreadedStereoConvolutionReverb convolution_;
+#else
   StereoConvolutionReverb convolution_;
+#endif
   Filter reverbLowPass_;
   Filter reverbHighPass_;
   float reverbGain_ = 1.0f;
 
-  // IR storage for selectIR
-  struct IRData
-  {
-    std::vector<float> samples;
-    size_t lengthPerChannel;
-    int numChannels;
-  };
-  std::vector<IRData> irStorage_;
+  // IRs live as frequency-domain caches inside convolution_
   int activeIRIndex_ = -1;
 
   // Master chain
@@ -110,13 +314,73 @@ private:
   float masterLimiterGain_ = 1.0f;
   Limiter masterLimiter_;
 
-  // Transport
+  // Transport: the scheduler holds the beat grid in absolute frame time;
+  // process() pops this block's events and splits player runs at their
+  // offsets, so triggers are sample-accurate instead of quantized to the
+  // render quantum
   float bpm_ = 140.0f;
   bool looping_ = false;
   int samplesPerBeat_ = 0;
-  int samplesSinceBeat_ = 0;
-  int noiseBeatCount_ = 0;
-  bool pendingNoiseTrigger_ = false;
+  EventScheduler scheduler_;
+  static constexpr int kMaxBlockEvents = 8;
+
+  // Sum the active kick voices into kickL_/kickR_ over [start, end)
+  void renderKickVoices(int start, int end);
+
+  // Per-stage durations for the last kTimingRingBlocks blocks, one row of
+  // kNumTimingStages floats (ms) per block in stage order kick, noise,
+  // reverb, master OTT, master out. The audio thread writes a row and then
+  // publishes the position; rows are plain floats, so a poll racing a
+  // write can tear, which only miscolors one frame of metering.
+  static constexpr int kNumTimingStages = 5;
+  static constexpr int kTimingRingBlocks = 64;
+  std::array<float, kTimingRingBlocks * kNumTimingStages> timingRing_{};
+  std::array<float, kNumTimingStages> stageMaxMs_{};
+  std::atomic<uint32_t> timingRingRows_{ 0 };
+  std::atomic<float> cpuLoad_{ 0.0f };
+  std::atomic<uint32_t> overruns_{ 0 };
+  static constexpr float kCpuLoadSmoothing = 0.02f; // ~0.13s at 375 blocks/s
+
+  // Meter taps (see getMeterLevels). The levels are plain floats like the
+  // timing rows: a poll racing a write can tear, which at worst miscolors
+  // one frame of a VU bar. numSamples 0 decays a silent bus toward zero.
+  enum class MeterBus : uint8_t
+  {
+    kick,
+    reverb,
+    master,
+  };
+
+  void meterTap(MeterBus bus, const float* left, const float* right,
+                int numSamples);
+
+  static constexpr int kNumMeterBuses = 3;
+  static constexpr float kMeterPeakFallSeconds = 0.4f;
+  static constexpr float kMeterRmsSeconds = 0.05f;
+  std::array<float, kNumMeterBuses * 2> meterLevels_{};
+  std::array<float, kNumMeterBuses> meterMeanSq_{};
+  float meterPeakFall_ = 0.0f;
+  float meterRmsCoeff_ = 0.0f;
+
+  // Kick render cache (preallocated in prepare; capture spills past the
+  // cap fall back to live processing). Sample-aligned: the cache starts at
+  // the trigger sample, and replay tracks the cache index of each block's
+  // first sample, which goes negative when a beat lands mid-block.
+  static constexpr float kMaxKickCacheSeconds = 2.0f;
+  static constexpr float kKickCacheSilence = 1.0e-6f;
+  std::vector<float> kickCacheL_;
+  std::vector<float> kickCacheR_;
+  KickCacheState kickCacheState_ = KickCacheState::invalid;
+  int kickCacheCapacity_ = 0; // in samples
+  int kickCacheSamples_ = 0;
+  int kickCaptureOffset_ = 0; // capture start within the trigger block
+  int kickReplayPos_ = 0;
+
+  // Persistent output region read by the worklet through a HEAPF32 view;
+  // the engine has no audio input, so there is no input counterpart
+  static constexpr int kMaxRenderBatch = 8;
+  alignas(16) std::array<float, kBlockSize * kMaxRenderBatch> pinnedOutL_{};
+  alignas(16) std::array<float, kBlockSize * kMaxRenderBatch> pinnedOutR_{};
 
   // Scratch buffers (fixed at AudioWorklet block size)
   std::array<float, kBlockSize> kickL_{};
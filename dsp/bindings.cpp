@@ -0,0 +1,70 @@
+// Embind layer for the AudioWorklet build. Kept out of audio_engine.cpp so
+// the DSP code itself has no Emscripten dependency and links into native
+// profiling builds unchanged.
+
+#include "audio_engine.h"
+
+#include <emscripten/bind.h>
+
+EMSCRIPTEN_BINDINGS(audio_module)
+{
+  emscripten::class_<AudioEngine>("AudioEngine")
+    .constructor()
+    .function("prepare", &AudioEngine::prepare)
+    .function("process", &AudioEngine::process)
+    .function("renderOffline", &AudioEngine::renderOffline)
+    // Persistent output region (offsets read once, then viewed via HEAPF32)
+    .function("getOutputBufferLeft", &AudioEngine::getOutputBufferLeft)
+    .function("getOutputBufferRight", &AudioEngine::getOutputBufferRight)
+    .function("getMaxRenderBatch", &AudioEngine::getMaxRenderBatch)
+    .function("render", &AudioEngine::render)
+    .function("clearSamples", &AudioEngine::clearSamples)
+    .function("getPendingLoads", &AudioEngine::getPendingLoads)
+    // Presets (packed EnginePreset blobs, copied via a HEAPU8 view)
+    .function("applyPreset", &AudioEngine::applyPreset)
+    .function("capturePreset", &AudioEngine::capturePreset)
+    .function("getPresetSize", &AudioEngine::getPresetSize)
+    // Kick
+    .function("loadKickSample", &AudioEngine::loadKickSample)
+    .function("selectKickSample", &AudioEngine::selectKickSample)
+    .function("setKickVoiceSample", &AudioEngine::setKickVoiceSample)
+    .function("setKickVoiceVolume", &AudioEngine::setKickVoiceVolume)
+    .function("getNumKickVoices", &AudioEngine::getNumKickVoices)
+    .function("setKickLength", &AudioEngine::setKickLength)
+    .function("setKickDistortion", &AudioEngine::setKickDistortion)
+    .function("setKickOTT", &AudioEngine::setKickOTT)
+    // Noise
+    .function("loadNoiseSample", &AudioEngine::loadNoiseSample)
+    .function("selectNoiseSample", &AudioEngine::selectNoiseSample)
+    .function("setNoiseVolume", &AudioEngine::setNoiseVolume)
+    .function("setNoiseLowPass", &AudioEngine::setNoiseLowPass)
+    .function("setNoiseHighPass", &AudioEngine::setNoiseHighPass)
+    // Reverb
+    .function("loadIR", &AudioEngine::loadIR)
+    .function("loadPreparedIR", &AudioEngine::loadPreparedIR)
+    .function("selectIR", &AudioEngine::selectIR)
+    .function("setReverbLowPass", &AudioEngine::setReverbLowPass)
+    .function("setReverbHighPass", &AudioEngine::setReverbHighPass)
+    .function("setReverbVolume", &AudioEngine::setReverbVolume)
+    // Master
+    .function("setMasterOTT", &AudioEngine::setMasterOTT)
+    .function("setMasterDistortion", &AudioEngine::setMasterDistortion)
+    .function("setMasterLimiter", &AudioEngine::setMasterLimiter)
+    // CPU instrumentation (pointer getters are read via a HEAPF32 view)
+    .function("getCpuLoad", &AudioEngine::getCpuLoad)
+    .function("getStageTimings", &AudioEngine::getStageTimings)
+    .function("getTimingRingPosition", &AudioEngine::getTimingRingPosition)
+    .function("getStageMaxTimings", &AudioEngine::getStageMaxTimings)
+    .function("getOverrunCount", &AudioEngine::getOverrunCount)
+    .function("resetCpuStats", &AudioEngine::resetCpuStats)
+    .function("getNumTimingStages", &AudioEngine::getNumTimingStages)
+    .function("getTimingRingBlocks", &AudioEngine::getTimingRingBlocks)
+    // Bus meters ([peak, rms] pairs, read via a HEAPF32 view)
+    .function("getMeterLevels", &AudioEngine::getMeterLevels)
+    .function("getNumMeterBuses", &AudioEngine::getNumMeterBuses)
+    // Transport
+    .function("setBPM", &AudioEngine::setBPM)
+    .function("setLooping", &AudioEngine::setLooping)
+    .function("cue", &AudioEngine::cue)
+    .function("cueRelease", &AudioEngine::cueRelease);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Wait-free single-producer/single-consumer ring: the JS main thread pushes
+// parameter changes, the audio callback pops them at block boundaries.
+// Capacity must be a power of two. push never blocks; it returns false when
+// the queue is full and the caller decides what to drop.
+template <typename T, size_t Capacity>
+class CommandQueue
+{
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+public:
+  bool push(const T& item)
+  {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == Capacity)
+      return false;
+
+    slots_[tail & (Capacity - 1)] = item;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T& item)
+  {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+      return false;
+
+    item = slots_[head & (Capacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::array<T, Capacity> slots_{};
+  std::atomic<size_t> head_{ 0 };
+  std::atomic<size_t> tail_{ 0 };
+};
@@ -1,5 +1,9 @@
 #include "convolution-mt.h"
 
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 void
 multiplyAndAccumulateFFTs(const std::vector<float>& fftDry,
                           const std::vector<float>& fftIr,
@@ -8,6 +12,25 @@ multiplyAndAccumulateFFTs(const std::vector<float>& fftDry,
   // (a + bi) (c + di)
   // ac + cbi + adi + bdi^2
   // ac - bd + i (cb + ad)
+#if defined(__wasm_simd128__)
+  // interleaved complex layout: each 128-bit lane holds two bins (a b a' b')
+  const v128_t signFlip = wasm_f32x4_const(-1.0f, 1.0f, -1.0f, 1.0f);
+  for (size_t i = 0; i < fftDry.size(); i += 4) {
+    v128_t dry = wasm_v128_load(fftDry.data() + i);
+    v128_t ir = wasm_v128_load(fftIr.data() + i);
+    v128_t out = wasm_v128_load(fftOutput.data() + i);
+
+    v128_t dryRe = wasm_i32x4_shuffle(dry, dry, 0, 0, 2, 2); // (a a a' a')
+    v128_t dryIm = wasm_i32x4_shuffle(dry, dry, 1, 1, 3, 3); // (b b b' b')
+    v128_t irSwap = wasm_i32x4_shuffle(ir, ir, 1, 0, 3, 2);  // (d c d' c')
+
+    // (ac, ad, ...) + (-bd, bc, ...) = (ac - bd, ad + bc, ...)
+    v128_t acad = wasm_f32x4_mul(dryRe, ir);
+    v128_t bdbc = wasm_f32x4_mul(wasm_f32x4_mul(dryIm, irSwap), signFlip);
+    out = wasm_f32x4_add(out, wasm_f32x4_add(acad, bdbc));
+    wasm_v128_store(fftOutput.data() + i, out);
+  }
+#else
   for (size_t i = 0; i < fftDry.size(); i += 2) {
     float a = fftDry[i];
     float b = fftDry[i + 1];
@@ -16,41 +39,74 @@ multiplyAndAccumulateFFTs(const std::vector<float>& fftDry,
     fftOutput[i] += a * c - b * d;
     fftOutput[i + 1] += c * b + a * d;
   }
+#endif
 }
 
-void
-EarlyConvolutionEngine::loadIR(const float* irData, const size_t irLength)
+// one segmentation serves both engines: the early engine reads segment 0,
+// the late engine segments 1..n-1
+static PreparedIRChannel
+segmentIRChannel(juce::dsp::FFT& fft, const float* irData, size_t irLength)
 {
-  if (irLength == 0 || irData == nullptr)
-    return;
-
-  // initialize overlap buffer (this seems like the best place to do it)
-  overlapBuffer_.resize(fftSize_, 0.0f);
+  constexpr size_t blockSize = kRenderBlockSize;
+  constexpr size_t fftSize = 4 * blockSize;
+  constexpr size_t segmentSize = fftSize - blockSize;
 
-  // clear any stale buffers
-  reset();
+  PreparedIRChannel ir;
+  if (irLength == 0 || irData == nullptr)
+    return ir;
 
   // calculate number of ffts (segments)
   // note ceil(a /b) = (a + b - 1) / b and this avoids type conversions
-  numIrSegments_ = (irLength + segmentSize_ - 1) / segmentSize_;
-  irSegmentsFFT_.resize(numIrSegments_);
+  ir.numSegments = (irLength + segmentSize - 1) / segmentSize;
+  ir.segmentsFFT.resize(ir.numSegments);
 
-  for (size_t segment = 0; segment < numIrSegments_; segment++) {
+  for (size_t segment = 0; segment < ir.numSegments; segment++) {
     // resize segment and fill with 0s
-    irSegmentsFFT_[segment].resize(fftSize_ * 2, 0.0f);
+    ir.segmentsFFT[segment].resize(fftSize * 2, 0.0f);
 
     // fill segment with ir samples
-    size_t offset = segment * segmentSize_;
-    size_t segmentSizeAdj = std::min(segmentSize_, irLength - offset);
+    size_t offset = segment * segmentSize;
+    size_t segmentSizeAdj = std::min(segmentSize, irLength - offset);
     for (size_t sample = 0; sample < segmentSizeAdj; sample++) {
-      irSegmentsFFT_[segment][sample] = irData[sample + offset];
+      ir.segmentsFFT[segment][sample] = irData[sample + offset];
     }
 
     // apply fft on segment
-    fft_.performRealOnlyForwardTransform(irSegmentsFFT_[segment].data());
+    fft.performRealOnlyForwardTransform(ir.segmentsFFT[segment].data());
   }
 
+  return ir;
+}
+
+void
+EarlyConvolutionEngine::loadIR(const float* irData, const size_t irLength)
+{
+  if (irLength == 0 || irData == nullptr)
+    return;
+
+  ownedIR_ = prepareIR(irData, irLength);
+  setPreparedIR(&ownedIR_);
+}
+
+PreparedIRChannel
+EarlyConvolutionEngine::prepareIR(const float* irData, const size_t irLength)
+{
+  return segmentIRChannel(fft_, irData, irLength);
+}
+
+void
+EarlyConvolutionEngine::setPreparedIR(const PreparedIRChannel* ir)
+{
+  activeIR_ = ir;
+  if (ir == nullptr || ir->numSegments == 0) {
+    irLoaded_ = false;
+    return;
+  }
+
+  // fixed size, so this only allocates the first time through
+  overlapBuffer_.resize(fftSize_, 0.0f);
   irLoaded_ = true;
+  reset();
 }
 
 void
@@ -74,7 +130,7 @@ EarlyConvolutionEngine::process(const float* input,
 
   // multiply 0 index segment dry FFT with 0 index segment ir FFT
   std::vector<float> combined(fftSize_ * 2, 0.0f);
-  multiplyAndAccumulateFFTs(drySegment, irSegmentsFFT_[0], combined);
+  multiplyAndAccumulateFFTs(drySegment, activeIR_->segmentsFFT[0], combined);
 
   // take IFFT
   fft_.performRealOnlyInverseTransform(combined.data());
@@ -100,7 +156,6 @@ EarlyConvolutionEngine::process(const float* input,
 void
 EarlyConvolutionEngine::reset()
 {
-  currSegment_ = 0;
   std::fill(overlapBuffer_.begin(), overlapBuffer_.end(), 0.0f);
 }
 
@@ -110,35 +165,34 @@ LateConvolutionEngine::loadIR(const float* irData, const size_t irLength)
   if (irLength == 0 || irData == nullptr)
     return;
 
-  // initialize overlap buffer (this seems like the best place to do it)
-  overlapBuffer_.resize(fftSize_, 0.0f);
-
-  // clear any stale buffers
-  reset();
-
-  // calculate number of ffts (segments)
-  // note ceil(a /b) = (a + b - 1) / b and this avoids type conversions
-  numIrSegments_ = (irLength + segmentSize_ - 1) / segmentSize_;
-  irSegmentsFFT_.resize(numIrSegments_);
-  inputHistoryFFT_.resize(numIrSegments_);
+  ownedIR_ = segmentIRChannel(fft_, irData, irLength);
+  setPreparedIR(&ownedIR_);
+}
 
-  for (size_t segment = 0; segment < numIrSegments_; segment++) {
-    // resize segment and fill with 0s
-    irSegmentsFFT_[segment].resize(fftSize_ * 2, 0.0f);
-    inputHistoryFFT_[segment].resize(fftSize_ * 2, 0.0f);
+void
+LateConvolutionEngine::setPreparedIR(const PreparedIRChannel* ir)
+{
+  activeIR_ = ir;
+  if (ir == nullptr || ir->numSegments == 0) {
+    irLoaded_ = false;
+    return;
+  }
 
-    // fill segment with ir samples
-    size_t offset = segment * segmentSize_;
-    size_t segmentSizeAdj = std::min(segmentSize_, irLength - offset);
-    for (size_t sample = 0; sample < segmentSizeAdj; sample++) {
-      irSegmentsFFT_[segment][sample] = irData[sample + offset];
-    }
+  numIrSegments_ = ir->numSegments;
+  overlapBuffer_.resize(fftSize_, 0.0f);
 
-    // apply fft on segment
-    fft_.performRealOnlyForwardTransform(irSegmentsFFT_[segment].data());
-  }
+  // segments hop segmentSize_ (384) but input blocks hop blockSize_ (128),
+  // so segment k pairs with the input 3k blocks back and the history must
+  // be three entries deep per segment. Grow-only: a deeper ring than the
+  // current IR needs just keeps older entries around, and switching back
+  // to a shorter IR never reallocates.
+  if (inputHistoryFFT_.size() < numIrSegments_ * 3)
+    inputHistoryFFT_.resize(numIrSegments_ * 3);
+  for (auto& history : inputHistoryFFT_)
+    history.resize(fftSize_ * 2, 0.0f);
 
   irLoaded_ = true;
+  reset();
 }
 
 void
@@ -161,14 +215,20 @@ LateConvolutionEngine::process(const float* input,
   // add dry fft to history
   inputHistoryFFT_[currSegment_] = drySegment;
 
-  // calculations for [1..n-1] segments
+  // calculations for [1..n-1] segments; note the output is the late-field
+  // contribution due ONE block after `input`, which is what lets a
+  // background thread compute it between callbacks while the early engine
+  // handles segment 0 in sync
   std::vector<float> combined(fftSize_ * 2, 0.0f);
+  size_t historySize = inputHistoryFFT_.size();
   for (size_t segment = 1; segment < numIrSegments_; segment++) {
-    // multiply and accumulate dry fft and ir fft onto the combined buffer
+    // multiply and accumulate dry fft and ir fft onto the combined buffer;
+    // segment k is offset k * segmentSize_ into the IR = 3k blocks
     size_t segmentsBackIdx =
-      (currSegment_ + numIrSegments_ - segment) % numIrSegments_;
-    multiplyAndAccumulateFFTs(
-      inputHistoryFFT_[segmentsBackIdx], irSegmentsFFT_[segment], combined);
+      (currSegment_ + 1 + historySize - segment * 3) % historySize;
+    multiplyAndAccumulateFFTs(inputHistoryFFT_[segmentsBackIdx],
+                              activeIR_->segmentsFFT[segment],
+                              combined);
   }
 
   // take IFFT
@@ -192,7 +252,7 @@ LateConvolutionEngine::process(const float* input,
             0.0f);
 
   // advance current segment
-  currSegment_ = (currSegment_ + 1) % numIrSegments_;
+  currSegment_ = (currSegment_ + 1) % inputHistoryFFT_.size();
 }
 
 void
@@ -228,6 +288,14 @@ EarlyStereoConvolutionReverb::loadIR(const float* irData,
   }
 }
 
+void
+EarlyStereoConvolutionReverb::setPreparedIR(const PreparedIRChannel* left,
+                                            const PreparedIRChannel* right)
+{
+  leftEngine_.setPreparedIR(left);
+  rightEngine_.setPreparedIR(right);
+}
+
 void
 EarlyStereoConvolutionReverb::process(float* left, float* right, int numSamples)
 {
@@ -264,6 +332,14 @@ LateStereoConvolutionReverb::loadIR(const float* irData,
   }
 }
 
+void
+LateStereoConvolutionReverb::setPreparedIR(const PreparedIRChannel* left,
+                                           const PreparedIRChannel* right)
+{
+  leftEngine_.setPreparedIR(left);
+  rightEngine_.setPreparedIR(right);
+}
+
 void
 LateStereoConvolutionReverb::process(float* left, float* right, int numSamples)
 {
@@ -277,3 +353,266 @@ LateStereoConvolutionReverb::reset()
   leftEngine_.reset();
   rightEngine_.reset();
 }
+
+// --- ThreadedStereoConvolutionReverb ---
+
+ThreadedStereoConvolutionReverb::~ThreadedStereoConvolutionReverb()
+{
+  stopWorker();
+}
+
+void
+ThreadedStereoConvolutionReverb::prepare(float sampleRate)
+{
+  (void)sampleRate; // engines are sample-rate agnostic
+  dryBuffer_.resize(blockSize_ * 2);
+}
+
+void
+ThreadedStereoConvolutionReverb::loadIR(const float* irData,
+                                        size_t irLengthPerChannel,
+                                        int numChannels)
+{
+  selectPreparedIR(addPreparedIR(irData, irLengthPerChannel, numChannels));
+}
+
+size_t
+ThreadedStereoConvolutionReverb::addPreparedIR(const float* irData,
+                                               size_t irLengthPerChannel,
+                                               int numChannels)
+{
+  return adoptPreparedIR(buildPreparedIR(irData, irLengthPerChannel,
+                                         numChannels));
+}
+
+std::unique_ptr<ThreadedStereoConvolutionReverb::StereoPreparedIR>
+ThreadedStereoConvolutionReverb::buildPreparedIR(const float* irData,
+                                                 size_t irLengthPerChannel,
+                                                 int numChannels) const
+{
+  // scratch engines so the transforms never share state with the live
+  // pair; the segmentation is a compile-time geometry, so the result is
+  // interchangeable
+  EarlyConvolutionEngine scratchLeft;
+  EarlyConvolutionEngine scratchRight;
+
+  auto prepared = std::make_unique<StereoPreparedIR>();
+
+  if (numChannels == 1) {
+    prepared->left = scratchLeft.prepareIR(irData, irLengthPerChannel);
+    prepared->right = scratchRight.prepareIR(irData, irLengthPerChannel);
+  } else {
+    std::vector<float> leftIR(irLengthPerChannel);
+    std::vector<float> rightIR(irLengthPerChannel);
+
+    for (size_t i = 0; i < irLengthPerChannel; ++i) {
+      leftIR[i] = irData[i * 2];
+      rightIR[i] = irData[i * 2 + 1];
+    }
+
+    prepared->left = scratchLeft.prepareIR(leftIR.data(), irLengthPerChannel);
+    prepared->right =
+      scratchRight.prepareIR(rightIR.data(), irLengthPerChannel);
+  }
+
+  return prepared;
+}
+
+size_t
+ThreadedStereoConvolutionReverb::adoptPreparedIR(
+  std::unique_ptr<StereoPreparedIR> prepared)
+{
+  // no capacity work here: the late engines are worker-owned, so their
+  // history grows on the worker when the IR is first selected
+  irStorage_.push_back(std::move(prepared));
+  return irStorage_.size() - 1;
+}
+
+void
+ThreadedStereoConvolutionReverb::selectPreparedIR(size_t index)
+{
+  if (index >= irStorage_.size())
+    return;
+
+  const StereoPreparedIR* ir = irStorage_[index].get();
+
+  // the early engines belong to this (audio) thread, so they swap here;
+  // the late engines belong to the worker, so the swap is parked for it to
+  // adopt before its next block. The tail switches one worker block behind
+  // the early field, which beats joining the worker from the audio thread.
+  early_.setPreparedIR(&ir->left, &ir->right);
+  pendingLateIR_.store(ir, std::memory_order_release);
+  irLoaded_ = true;
+  startWorker();
+}
+
+void
+ThreadedStereoConvolutionReverb::process(float* left,
+                                         float* right,
+                                         int numSamples)
+{
+  if (!irLoaded_ || static_cast<size_t>(numSamples) != blockSize_) {
+    return; // worklet always delivers 128-sample blocks
+  }
+
+  if (dryBuffer_.size() < blockSize_ * 2)
+    dryBuffer_.resize(blockSize_ * 2);
+
+  for (size_t i = 0; i < blockSize_; ++i) {
+    dryBuffer_[i] = left[i];
+    dryBuffer_[blockSize_ + i] = right[i];
+  }
+
+  // hand the dry block to the worker before the early engine runs in
+  // place. The late engine's delay line advances once per block it is fed,
+  // so when the queue overflows the dropped indices are made up with zero
+  // blocks as space frees; alignment then self-heals after a transient
+  // overload instead of lagging until the next reset. Past maxHealBlocks_
+  // the zeros would have flushed the whole history anyway, so a long stall
+  // is healed with one worker-side reset instead of replaying the backlog.
+  if (blockCounter_ - nextInputIndex_ > maxHealBlocks_) {
+    pendingLateReset_.store(true, std::memory_order_release);
+    nextInputIndex_ = blockCounter_;
+  }
+  size_t inTail = inputTail_.load(std::memory_order_relaxed);
+  size_t inHead = inputHead_.load(std::memory_order_acquire);
+  bool pushed = false;
+  while (inTail - inHead < queueCapacity_ && nextInputIndex_ <= blockCounter_) {
+    Block& slot = inputQueue_[inTail % queueCapacity_];
+    slot.blockIndex = nextInputIndex_;
+    if (nextInputIndex_ == blockCounter_) {
+      std::copy(left, left + blockSize_, slot.left.data());
+      std::copy(right, right + blockSize_, slot.right.data());
+    } else {
+      slot.left.fill(0.0f);
+      slot.right.fill(0.0f);
+    }
+    nextInputIndex_++;
+    inTail++;
+    pushed = true;
+  }
+  if (pushed) {
+    inputTail_.store(inTail, std::memory_order_release);
+    inputTail_.notify_one();
+  }
+
+  early_.process(left, right, numSamples);
+
+  // mix in the late contribution the worker prepared from the previous
+  // block; stale blocks (worker fell behind) are discarded, not replayed
+  size_t outHead = outputHead_.load(std::memory_order_relaxed);
+  while (outHead != outputTail_.load(std::memory_order_acquire)) {
+    Block& slot = outputQueue_[outHead % queueCapacity_];
+    if (slot.blockIndex > blockCounter_)
+      break;
+
+    if (slot.blockIndex == blockCounter_) {
+      for (size_t i = 0; i < blockSize_; ++i) {
+        left[i] += slot.left[i];
+        right[i] += slot.right[i];
+      }
+    }
+
+    outHead++;
+    outputHead_.store(outHead, std::memory_order_release);
+    if (slot.blockIndex >= blockCounter_)
+      break;
+  }
+
+  for (size_t i = 0; i < blockSize_; ++i) {
+    left[i] = dryBuffer_[i] * dryLevel_ + left[i] * wetLevel_;
+    right[i] = dryBuffer_[blockSize_ + i] * dryLevel_ + right[i] * wetLevel_;
+  }
+
+  blockCounter_++;
+}
+
+void
+ThreadedStereoConvolutionReverb::setMix(float wetLevel, float dryLevel)
+{
+  wetLevel_ = wetLevel;
+  dryLevel_ = dryLevel;
+}
+
+void
+ThreadedStereoConvolutionReverb::reset()
+{
+  bool wasRunning = running_.load(std::memory_order_acquire);
+  if (wasRunning)
+    stopWorker();
+
+  early_.reset();
+  late_.reset();
+  inputHead_.store(0, std::memory_order_relaxed);
+  inputTail_.store(0, std::memory_order_relaxed);
+  outputHead_.store(0, std::memory_order_relaxed);
+  outputTail_.store(0, std::memory_order_relaxed);
+  blockCounter_ = 0;
+  nextInputIndex_ = 0;
+
+  if (wasRunning)
+    startWorker();
+}
+
+void
+ThreadedStereoConvolutionReverb::startWorker()
+{
+  if (running_.load(std::memory_order_acquire))
+    return;
+
+  running_.store(true, std::memory_order_release);
+  worker_ = std::thread([this] { workerLoop(); });
+}
+
+void
+ThreadedStereoConvolutionReverb::stopWorker()
+{
+  if (!running_.load(std::memory_order_acquire))
+    return;
+
+  running_.store(false, std::memory_order_release);
+  // bump the tail so a parked worker wakes up and observes running_ == false
+  inputTail_.fetch_add(1, std::memory_order_release);
+  inputTail_.notify_one();
+  if (worker_.joinable())
+    worker_.join();
+}
+
+void
+ThreadedStereoConvolutionReverb::workerLoop()
+{
+  while (running_.load(std::memory_order_acquire)) {
+    // adopt a parked IR switch between blocks; setPreparedIR grows the
+    // history here on the worker, never on the audio thread
+    if (const StereoPreparedIR* ir =
+          pendingLateIR_.exchange(nullptr, std::memory_order_acq_rel)) {
+      late_.setPreparedIR(&ir->left, &ir->right);
+    }
+    if (pendingLateReset_.exchange(false, std::memory_order_acq_rel))
+      late_.reset();
+
+    size_t inTail = inputTail_.load(std::memory_order_acquire);
+    size_t inHead = inputHead_.load(std::memory_order_relaxed);
+
+    if (inHead == inTail) {
+      inputTail_.wait(inTail, std::memory_order_acquire);
+      continue;
+    }
+
+    Block& in = inputQueue_[inHead % queueCapacity_];
+
+    size_t outTail = outputTail_.load(std::memory_order_relaxed);
+    if (outTail - outputHead_.load(std::memory_order_acquire) <
+        queueCapacity_) {
+      Block& out = outputQueue_[outTail % queueCapacity_];
+      // the late engine returns the contribution for the NEXT block
+      out.blockIndex = in.blockIndex + 1;
+      std::copy(in.left.begin(), in.left.end(), out.left.data());
+      std::copy(in.right.begin(), in.right.end(), out.right.data());
+      late_.process(out.left.data(), out.right.data(), blockSize_);
+      outputTail_.store(outTail + 1, std::memory_order_release);
+    }
+
+    inputHead_.store(inHead + 1, std::memory_order_release);
+  }
+}
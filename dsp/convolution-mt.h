@@ -1,26 +1,51 @@
 #pragma once
+#include "dsp_config.h"
+
+#include <array>
+#include <bit>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <thread>
 #include <vector>
 
+// Frequency-domain IR segments at the early/late hop (the 4x-block FFT),
+// computed once at load time and shared by both engines: the early engine
+// convolves segment 0 on the audio thread, the late engine segments 1..n-1
+// on the worker. Selecting an IR is then a pointer swap on both sides.
+struct PreparedIRChannel
+{
+  std::vector<std::vector<float>> segmentsFFT;
+  size_t numSegments = 0;
+};
+
 class EarlyConvolutionEngine
 {
 public:
   void loadIR(const float* irData, const size_t irLength);
+
+  // transform a raw IR into segments this engine (and the late engine at
+  // the same hop) can point at
+  PreparedIRChannel prepareIR(const float* irData, const size_t irLength);
+
+  // O(1) apart from sizing the fixed overlap buffer on the first call
+  void setPreparedIR(const PreparedIRChannel* ir);
+
   void process(const float* input, float* output, const size_t numSamples);
   void reset();
 
 private:
-  size_t numIrSegments_;
-  size_t currSegment_;
+  const PreparedIRChannel* activeIR_ = nullptr;
+  PreparedIRChannel ownedIR_; // backing storage for the plain loadIR path
   bool irLoaded_ = false;
 
-  std::vector<std::vector<float>> irSegmentsFFT_;
   std::vector<float> overlapBuffer_;
 
-  static constexpr int fftOrder_ = 9; // 2^9 = 512
-  static constexpr size_t fftSize_ = 512;
-  static constexpr size_t blockSize_ = 128;
+  static constexpr size_t blockSize_ = kRenderBlockSize;
+  static constexpr size_t fftSize_ = 4 * blockSize_; // 512 at 128 frames
+  static constexpr int fftOrder_ = std::bit_width(fftSize_) - 1;
   static constexpr size_t segmentSize_ = fftSize_ - blockSize_;
 
   juce::dsp::FFT fft_{ fftOrder_ };
@@ -30,21 +55,31 @@ class LateConvolutionEngine
 {
 public:
   void loadIR(const float* irData, const size_t irLength);
+
+  // Point the engine at prepared segments and clear state. Grows the input
+  // history to fit (grow-only, so revisiting a shorter IR never allocates);
+  // call it from the thread that owns this engine, which in the threaded
+  // reverb is the worker.
+  void setPreparedIR(const PreparedIRChannel* ir);
+
+  // output is the late-field contribution due one block AFTER `input`, so
+  // a background thread can compute it between callbacks
   void process(const float* input, float* output, const size_t numSamples);
   void reset();
 
 private:
-  size_t numIrSegments_;
-  size_t currSegment_;
+  const PreparedIRChannel* activeIR_ = nullptr;
+  PreparedIRChannel ownedIR_; // backing storage for the plain loadIR path
+  size_t numIrSegments_ = 0;
+  size_t currSegment_ = 0;
   bool irLoaded_ = false;
 
-  std::vector<std::vector<float>> irSegmentsFFT_;
   std::vector<std::vector<float>> inputHistoryFFT_;
   std::vector<float> overlapBuffer_;
 
-  static constexpr int fftOrder_ = 9; // 2^9 = 512
-  static constexpr size_t fftSize_ = 512;
-  static constexpr size_t blockSize_ = 128;
+  static constexpr size_t blockSize_ = kRenderBlockSize;
+  static constexpr size_t fftSize_ = 4 * blockSize_; // 512 at 128 frames
+  static constexpr int fftOrder_ = std::bit_width(fftSize_) - 1;
   static constexpr size_t segmentSize_ = fftSize_ - blockSize_;
 
   juce::dsp::FFT fft_{ fftOrder_ };
@@ -54,6 +89,8 @@ class EarlyStereoConvolutionReverb
 {
 public:
   void loadIR(const float* irData, size_t irLengthPerChannel, int numChannels);
+  void setPreparedIR(const PreparedIRChannel* left,
+                     const PreparedIRChannel* right);
   void process(float* left, float* right, int numSamples);
   void reset();
 
@@ -66,6 +103,8 @@ class LateStereoConvolutionReverb
 {
 public:
   void loadIR(const float* irData, size_t irLengthPerChannel, int numChannels);
+  void setPreparedIR(const PreparedIRChannel* left,
+                     const PreparedIRChannel* right);
   void process(float* left, float* right, int numSamples);
   void reset();
 
@@ -73,3 +112,96 @@ private:
   LateConvolutionEngine leftEngine_;
   LateConvolutionEngine rightEngine_;
 };
+
+// Early segment convolved synchronously on the audio thread, late tail
+// offloaded to a worker (an Emscripten pthread backed by SharedArrayBuffer
+// under -pthread builds) through wait-free SPSC block rings. The late
+// engine produces each block's contribution one block ahead, so the worker
+// has a full callback interval to finish before the result is mixed in; if
+// it falls behind, that block's tail is dropped rather than blocking.
+class ThreadedStereoConvolutionReverb
+{
+public:
+  struct StereoPreparedIR
+  {
+    PreparedIRChannel left;
+    PreparedIRChannel right;
+  };
+
+  ThreadedStereoConvolutionReverb() = default;
+  ~ThreadedStereoConvolutionReverb();
+
+  void prepare(float sampleRate);
+  void loadIR(const float* irData, size_t irLengthPerChannel, int numChannels);
+  void process(float* left, float* right, int numSamples);
+  void setMix(float wetLevel, float dryLevel);
+  void reset();
+
+  // FFT the IR once and keep it; returns the cache index
+  size_t addPreparedIR(const float* irData,
+                       size_t irLengthPerChannel,
+                       int numChannels);
+
+  // Swap onto a cached IR without stopping the worker: the early engines
+  // switch immediately on the calling (audio) thread, the late engines pick
+  // the switch up on the worker between blocks
+  void selectPreparedIR(size_t index);
+
+  size_t numPreparedIRs() const { return irStorage_.size(); }
+
+  // The same transform work split in two for the async loader: build runs
+  // on a scratch transform and touches no live state, so a worker thread
+  // can do it while process() is active; adopt installs the entry at a
+  // block boundary on the audio thread
+  std::unique_ptr<StereoPreparedIR> buildPreparedIR(const float* irData,
+                                                    size_t irLengthPerChannel,
+                                                    int numChannels) const;
+  size_t adoptPreparedIR(std::unique_ptr<StereoPreparedIR> prepared);
+
+private:
+  static constexpr size_t blockSize_ = kRenderBlockSize;
+  static constexpr size_t queueCapacity_ = 8; // power of two
+
+  // longest gap healed by feeding zero blocks; anything longer is resynced
+  // with a worker-side reset instead (see process)
+  static constexpr size_t maxHealBlocks_ = 4 * queueCapacity_;
+
+  struct Block
+  {
+    size_t blockIndex;
+    std::array<float, blockSize_> left;
+    std::array<float, blockSize_> right;
+  };
+
+  void startWorker();
+  void stopWorker();
+  void workerLoop();
+
+  EarlyStereoConvolutionReverb early_;
+  LateStereoConvolutionReverb late_; // touched only by the worker once started
+
+  std::array<Block, queueCapacity_> inputQueue_;
+  std::array<Block, queueCapacity_> outputQueue_;
+  std::atomic<size_t> inputHead_{ 0 };
+  std::atomic<size_t> inputTail_{ 0 };
+  std::atomic<size_t> outputHead_{ 0 };
+  std::atomic<size_t> outputTail_{ 0 };
+  std::atomic<bool> running_{ false };
+  std::thread worker_;
+
+  // IR switch parked by selectPreparedIR for the worker to adopt, so the
+  // audio thread never joins or blocks on the worker to swap IRs
+  std::atomic<const StereoPreparedIR*> pendingLateIR_{ nullptr };
+
+  // set when a stall outlasted maxHealBlocks_: the worker clears the late
+  // engine instead of replaying the whole zero-block backlog
+  std::atomic<bool> pendingLateReset_{ false };
+
+  std::vector<std::unique_ptr<StereoPreparedIR>> irStorage_;
+  std::vector<float> dryBuffer_;
+  size_t blockCounter_ = 0;
+  size_t nextInputIndex_ = 0; // next block index owed to the late engine
+  float wetLevel_ = 0.3f;
+  float dryLevel_ = 0.7f;
+  bool irLoaded_ = false;
+};
@@ -1,29 +1,149 @@
 #include "convolution.h"
+#include "denormal.h"
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
 
 // --- ConvolutionEngine ---
 
 void ConvolutionEngine::prepare(float sampleRate)
 {
   sampleRate_ = sampleRate;
+
+  // reserve the input-side state for the longest supported IR up front;
+  // adoptPreparedIR runs inside the render callback in async-loader
+  // builds, so any capacity growth there would allocate on the audio
+  // thread
+  PreparedIR bound;
+  bound.numSegments = numHeadSegments_;
+  bound.numTailSegments = tailSegmentsFor(maxIRLength(sampleRate));
+  ensureCapacity(bound);
+
   reset();
 }
 
+size_t ConvolutionEngine::maxIRLength(float sampleRate)
+{
+  return static_cast<size_t>(sampleRate * kMaxIRSeconds);
+}
+
+size_t ConvolutionEngine::tailSegmentsFor(size_t irLength)
+{
+  size_t tailLength = (irLength > tailIrOffset_) ? irLength - tailIrOffset_ : 0;
+  return (tailLength + tailPartitionSize_ - 1) / tailPartitionSize_;
+}
+
 void ConvolutionEngine::loadIR(const float* irData, size_t irLength)
 {
   if (irLength == 0 || irData == nullptr)
     return;
 
-  numSegments_ = (irLength + segmentSize_ - 1) / segmentSize_;
-  numInputSegments_ = numSegments_ * 3;
+  ownedIR_ = prepareIR(irData, irLength);
+  ensureCapacity(ownedIR_);
+  setPreparedIR(&ownedIR_);
+}
+
+ConvolutionEngine::PreparedIR ConvolutionEngine::prepareIR(const float* irData,
+                                                           size_t irLength)
+{
+  PreparedIR ir;
+  if (irLength == 0 || irData == nullptr)
+    return ir;
+
+  size_t headLength = std::min(irLength, tailIrOffset_);
+  ir.numSegments = (headLength + segmentSize_ - 1) / segmentSize_;
+
+  ir.headSegments.resize(ir.numSegments);
+  for (size_t seg = 0; seg < ir.numSegments; ++seg) {
+    ir.headSegments[seg].assign(fftSize_ * 2, 0.0f);
+
+    size_t srcOffset = seg * segmentSize_;
+    size_t copyLen = std::min(segmentSize_, headLength - srcOffset);
+
+    for (size_t i = 0; i < copyLen; ++i) {
+      ir.headSegments[seg][i] = irData[srcOffset + i];
+    }
+
+    fft_.performRealOnlyForwardTransform(ir.headSegments[seg].data());
+    prepareForConvolution(ir.headSegments[seg].data(), fftSize_);
+  }
+
+  // everything past the head goes into the large-partition tail
+  size_t tailLength = (irLength > tailIrOffset_) ? irLength - tailIrOffset_ : 0;
+  ir.numTailSegments = tailSegmentsFor(irLength);
+
+  ir.tailSegments.resize(ir.numTailSegments);
+  for (size_t seg = 0; seg < ir.numTailSegments; ++seg) {
+    ir.tailSegments[seg].assign(tailFftSize_ * 2, 0.0f);
 
-  irSegmentsFFT_.resize(numSegments_);
-  for (auto& segment : irSegmentsFFT_) {
-    segment.resize(fftSize_ * 2, 0.0f);
+    size_t srcOffset = seg * tailPartitionSize_;
+    size_t copyLen = std::min(tailPartitionSize_, tailLength - srcOffset);
+
+    for (size_t i = 0; i < copyLen; ++i) {
+      ir.tailSegments[seg][i] = irData[tailIrOffset_ + srcOffset + i];
+    }
+
+    tailFft_.performRealOnlyForwardTransform(ir.tailSegments[seg].data());
+    prepareForConvolution(ir.tailSegments[seg].data(), tailFftSize_);
   }
 
-  inputSegmentsFFT_.resize(numInputSegments_);
+  return ir;
+}
+
+bool ConvolutionEngine::importPreparedIR(const PreparedIRFileHeader& header,
+                                         const float* segmentData,
+                                         PreparedIR& ir)
+{
+  if (std::memcmp(header.magic, kPreparedIRMagic, 4) != 0 ||
+      header.version != kPreparedIRVersion || header.fftSize != fftSize_ ||
+      header.tailFftSize != tailFftSize_)
+    return false;
+
+  // segments prepared at another sample rate would load fine geometrically
+  // but play pitched; the blob must match the rate this engine runs at
+  if (header.sampleRate != static_cast<uint32_t>(sampleRate_))
+    return false;
+
+  // longer than the capacity prepare() reserved; accepting it would force
+  // input-side growth on the audio thread at adoption
+  if (header.numTailSegments > tailSegmentsFor(maxIRLength(sampleRate_)))
+    return false;
+
+  // head count is bounded by the fixed head length, and a non-empty tail
+  // implies the head is full
+  if (header.numHeadSegments == 0 ||
+      header.numHeadSegments > numHeadSegments_ ||
+      (header.numTailSegments > 0 &&
+       header.numHeadSegments != numHeadSegments_))
+    return false;
+
+  ir.numSegments = header.numHeadSegments;
+  ir.numTailSegments = header.numTailSegments;
+
+  ir.headSegments.resize(ir.numSegments);
+  for (size_t seg = 0; seg < ir.numSegments; ++seg) {
+    ir.headSegments[seg].assign(segmentData, segmentData + fftSize_ * 2);
+    segmentData += fftSize_ * 2;
+  }
+
+  ir.tailSegments.resize(ir.numTailSegments);
+  for (size_t seg = 0; seg < ir.numTailSegments; ++seg) {
+    ir.tailSegments[seg].assign(segmentData, segmentData + tailFftSize_ * 2);
+    segmentData += tailFftSize_ * 2;
+  }
+
+  return true;
+}
+
+void ConvolutionEngine::ensureCapacity(const PreparedIR& ir)
+{
+  size_t numInputSegments = ir.numSegments * 3;
+  if (inputSegmentsFFT_.size() < numInputSegments)
+    inputSegmentsFFT_.resize(numInputSegments);
   for (auto& segment : inputSegmentsFFT_) {
-    segment.resize(fftSize_ * 2, 0.0f);
+    if (segment.size() < fftSize_ * 2)
+      segment.resize(fftSize_ * 2, 0.0f);
   }
 
   inputBuffer_.resize(fftSize_, 0.0f);
@@ -31,20 +151,33 @@ void ConvolutionEngine::loadIR(const float* irData, size_t irLength)
   overlapBuffer_.resize(fftSize_, 0.0f);
   tempBuffer_.resize(fftSize_ * 2, 0.0f);
 
-  for (size_t seg = 0; seg < numSegments_; ++seg) {
-    std::fill(irSegmentsFFT_[seg].begin(), irSegmentsFFT_[seg].end(), 0.0f);
+  if (tailInputFFT_.size() < ir.numTailSegments)
+    tailInputFFT_.resize(ir.numTailSegments);
+  for (auto& segment : tailInputFFT_) {
+    if (segment.size() < tailFftSize_ * 2)
+      segment.resize(tailFftSize_ * 2, 0.0f);
+  }
 
-    size_t srcOffset = seg * segmentSize_;
-    size_t copyLen = std::min(segmentSize_, irLength - srcOffset);
+  if (ir.numTailSegments > 0) {
+    tailInputBuffer_.resize(tailPartitionSize_, 0.0f);
+    tailMacBuffer_.resize(tailFftSize_ * 2, 0.0f);
+    tailOutputRing_.resize(tailRingSize_, 0.0f);
+  }
+}
 
-    for (size_t i = 0; i < copyLen; ++i) {
-      irSegmentsFFT_[seg][i] = irData[srcOffset + i];
-    }
+void ConvolutionEngine::setPreparedIR(const PreparedIR* ir)
+{
+  activeIR_ = ir;
 
-    fft_.performRealOnlyForwardTransform(irSegmentsFFT_[seg].data());
-    prepareForConvolution(irSegmentsFFT_[seg].data());
+  if (ir == nullptr || ir->numSegments == 0) {
+    irLoaded_ = false;
+    return;
   }
 
+  numSegments_ = ir->numSegments;
+  numInputSegments_ = numSegments_ * 3;
+  numTailSegments_ = ir->numTailSegments;
+
   irLoaded_ = true;
   reset();
 }
@@ -56,6 +189,13 @@ void ConvolutionEngine::process(const float* input, float* output, int numSample
     return;
   }
 
+  // snap silent input to exact zero so a decaying source cannot fill the
+  // spectral history and overlap buffers with denormals, which have no
+  // flush-to-zero mode under WASM and crawl on several client CPUs
+  bool inputSilent = true;
+  for (int i = 0; i < numSamples && inputSilent; ++i)
+    inputSilent = std::fabs(input[i]) < kDenormalThreshold;
+
   int numSamplesProcessed = 0;
   size_t indexStep = numInputSegments_ / numSegments_;
 
@@ -66,7 +206,8 @@ void ConvolutionEngine::process(const float* input, float* output, int numSample
                blockSize_ - inputDataPos_);
 
     for (size_t i = 0; i < samplesToProcess; ++i) {
-      inputBuffer_[inputDataPos_ + i] = input[numSamplesProcessed + i];
+      inputBuffer_[inputDataPos_ + i] =
+        inputSilent ? 0.0f : input[numSamplesProcessed + i];
     }
 
     float* inputSegmentData = inputSegmentsFFT_[currentSegment_].data();
@@ -76,7 +217,7 @@ void ConvolutionEngine::process(const float* input, float* output, int numSample
       std::fill(
         inputSegmentData + fftSize_, inputSegmentData + fftSize_ * 2, 0.0f);
       fft_.performRealOnlyForwardTransform(inputSegmentData);
-      prepareForConvolution(inputSegmentData);
+      prepareForConvolution(inputSegmentData, fftSize_);
 
       std::fill(tempBuffer_.begin(), tempBuffer_.end(), 0.0f);
 
@@ -87,16 +228,19 @@ void ConvolutionEngine::process(const float* input, float* output, int numSample
           index -= numInputSegments_;
 
         convolutionProcessingAndAccumulate(inputSegmentsFFT_[index].data(),
-                                           irSegmentsFFT_[seg].data(),
-                                           tempBuffer_.data());
+                                           activeIR_->headSegments[seg].data(),
+                                           tempBuffer_.data(),
+                                           fftSize_);
       }
     }
 
     std::copy(tempBuffer_.begin(), tempBuffer_.end(), outputBuffer_.begin());
-    convolutionProcessingAndAccumulate(
-      inputSegmentData, irSegmentsFFT_[0].data(), outputBuffer_.data());
+    convolutionProcessingAndAccumulate(inputSegmentData,
+                                       activeIR_->headSegments[0].data(),
+                                       outputBuffer_.data(),
+                                       fftSize_);
 
-    updateSymmetricFrequencyDomainData(outputBuffer_.data());
+    updateSymmetricFrequencyDomainData(outputBuffer_.data(), fftSize_);
     fft_.performRealOnlyInverseTransform(outputBuffer_.data());
 
     for (size_t i = 0; i < samplesToProcess; ++i) {
@@ -104,9 +248,25 @@ void ConvolutionEngine::process(const float* input, float* output, int numSample
         outputBuffer_[inputDataPos_ + i] + overlapBuffer_[inputDataPos_ + i];
     }
 
+    // tail: capture input (from inputBuffer_, in case output aliases input)
+    // and mix in the large-partition result that is due at this sample
+    if (numTailSegments_ > 0) {
+      for (size_t i = 0; i < samplesToProcess; ++i) {
+        tailInputBuffer_[tailInputPos_++] = inputBuffer_[inputDataPos_ + i];
+        output[numSamplesProcessed + i] += tailOutputRing_[tailReadPos_];
+        tailOutputRing_[tailReadPos_] = 0.0f;
+        tailReadPos_ = (tailReadPos_ + 1) % tailRingSize_;
+
+        if (tailInputPos_ == tailPartitionSize_)
+          startTailJob();
+      }
+    }
+
     inputDataPos_ += samplesToProcess;
 
     if (inputDataPos_ == blockSize_) {
+      tailJobStep(tailInputFFT_);
+
       std::fill(inputBuffer_.begin(), inputBuffer_.end(), 0.0f);
       inputDataPos_ = 0;
 
@@ -121,6 +281,11 @@ void ConvolutionEngine::process(const float* input, float* output, int numSample
                 overlapBuffer_.end(),
                 0.0f);
 
+      if (--blocksUntilSanitize_ == 0) {
+        blocksUntilSanitize_ = sanitizeIntervalBlocks_;
+        flushDenormals(overlapBuffer_.data(), overlapBuffer_.size());
+      }
+
       currentSegment_ = (currentSegment_ > 0) ? (currentSegment_ - 1)
                                               : (numInputSegments_ - 1);
     }
@@ -129,6 +294,111 @@ void ConvolutionEngine::process(const float* input, float* output, int numSample
   }
 }
 
+void ConvolutionEngine::renderShared(const ConvolutionEngine& inputEngine,
+                                     float* output,
+                                     int numSamples)
+{
+  if (!irLoaded_)
+    return;
+
+  // mirror of process(), but all forward transforms are read from
+  // inputEngine; our own counters track the same positions because both
+  // engines are fed in lock step
+  int numSamplesProcessed = 0;
+  size_t indexStep = numInputSegments_ / numSegments_;
+
+  while (numSamplesProcessed < numSamples) {
+    bool inputBufferWasEmpty = (inputDataPos_ == 0);
+    size_t samplesToProcess =
+      std::min(static_cast<size_t>(numSamples - numSamplesProcessed),
+               blockSize_ - inputDataPos_);
+
+    const float* inputSegmentData =
+      inputEngine.inputSegmentsFFT_[currentSegment_].data();
+
+    if (inputBufferWasEmpty) {
+      std::fill(tempBuffer_.begin(), tempBuffer_.end(), 0.0f);
+
+      size_t index = currentSegment_;
+      for (size_t seg = 1; seg < numSegments_; ++seg) {
+        index += indexStep;
+        if (index >= numInputSegments_)
+          index -= numInputSegments_;
+
+        convolutionProcessingAndAccumulate(
+          inputEngine.inputSegmentsFFT_[index].data(),
+          activeIR_->headSegments[seg].data(),
+          tempBuffer_.data(),
+          fftSize_);
+      }
+    }
+
+    std::copy(tempBuffer_.begin(), tempBuffer_.end(), outputBuffer_.begin());
+    convolutionProcessingAndAccumulate(inputSegmentData,
+                                       activeIR_->headSegments[0].data(),
+                                       outputBuffer_.data(),
+                                       fftSize_);
+
+    updateSymmetricFrequencyDomainData(outputBuffer_.data(), fftSize_);
+    fft_.performRealOnlyInverseTransform(outputBuffer_.data());
+
+    for (size_t i = 0; i < samplesToProcess; ++i) {
+      output[numSamplesProcessed + i] =
+        outputBuffer_[inputDataPos_ + i] + overlapBuffer_[inputDataPos_ + i];
+    }
+
+    if (numTailSegments_ > 0) {
+      for (size_t i = 0; i < samplesToProcess; ++i) {
+        tailInputPos_++;
+        output[numSamplesProcessed + i] += tailOutputRing_[tailReadPos_];
+        tailOutputRing_[tailReadPos_] = 0.0f;
+        tailReadPos_ = (tailReadPos_ + 1) % tailRingSize_;
+
+        if (tailInputPos_ == tailPartitionSize_)
+          startSharedTailJob(inputEngine);
+      }
+    }
+
+    inputDataPos_ += samplesToProcess;
+
+    if (inputDataPos_ == blockSize_) {
+      tailJobStep(inputEngine.tailInputFFT_);
+
+      inputDataPos_ = 0;
+
+      for (size_t i = blockSize_; i < fftSize_; ++i) {
+        outputBuffer_[i] += overlapBuffer_[i];
+      }
+
+      std::copy(outputBuffer_.begin() + blockSize_,
+                outputBuffer_.begin() + fftSize_,
+                overlapBuffer_.begin());
+      std::fill(overlapBuffer_.begin() + (fftSize_ - blockSize_),
+                overlapBuffer_.end(),
+                0.0f);
+
+      if (--blocksUntilSanitize_ == 0) {
+        blocksUntilSanitize_ = sanitizeIntervalBlocks_;
+        flushDenormals(overlapBuffer_.data(), overlapBuffer_.size());
+      }
+
+      currentSegment_ = (currentSegment_ > 0) ? (currentSegment_ - 1)
+                                              : (numInputSegments_ - 1);
+    }
+
+    numSamplesProcessed += samplesToProcess;
+  }
+}
+
+void ConvolutionEngine::startSharedTailJob(const ConvolutionEngine& inputEngine)
+{
+  // the sharing engine already transformed this partition; only the MAC
+  // sweep and inverse transform remain, run incrementally from tailJobStep
+  if (tailJobActive_)
+    finishTailJob(inputEngine.tailInputFFT_);
+  beginTailJob();
+}
+
 void ConvolutionEngine::reset()
 {
   currentSegment_ = 0;
@@ -142,11 +412,102 @@ void ConvolutionEngine::reset()
   for (auto& segment : inputSegmentsFFT_) {
     std::fill(segment.begin(), segment.end(), 0.0f);
   }
+
+  currentTailSegment_ = 0;
+  tailInputPos_ = 0;
+  tailReadPos_ = 0;
+  tailJobActive_ = false;
+
+  std::fill(tailInputBuffer_.begin(), tailInputBuffer_.end(), 0.0f);
+  std::fill(tailMacBuffer_.begin(), tailMacBuffer_.end(), 0.0f);
+  std::fill(tailOutputRing_.begin(), tailOutputRing_.end(), 0.0f);
+
+  for (auto& segment : tailInputFFT_) {
+    std::fill(segment.begin(), segment.end(), 0.0f);
+  }
+}
+
+void ConvolutionEngine::startTailJob()
+{
+  // forward transform the partition of input that just completed; the MAC
+  // sweep and inverse transform run incrementally from tailJobStep
+  if (tailJobActive_)
+    finishTailJob(tailInputFFT_);
+
+  float* slot = tailInputFFT_[currentTailSegment_].data();
+  std::copy(tailInputBuffer_.begin(), tailInputBuffer_.end(), slot);
+  std::fill(slot + tailPartitionSize_, slot + tailFftSize_ * 2, 0.0f);
+  tailFft_.performRealOnlyForwardTransform(slot);
+  prepareForConvolution(slot, tailFftSize_);
+
+  beginTailJob();
+}
+
+void ConvolutionEngine::beginTailJob()
+{
+  tailInputPos_ = 0;
+
+  tailJobMacIndex_ = currentTailSegment_;
+  currentTailSegment_ = (currentTailSegment_ + 1) % numTailSegments_;
+  tailJobSegmentsDone_ = 0;
+  tailJobChunk_ =
+    (numTailSegments_ + tailSpreadBlocks_ - 1) / tailSpreadBlocks_;
+
+  // the result is due where the head coverage runs out; capture the ring
+  // position now because the read position advances while the job runs
+  tailJobWritePos_ =
+    (tailReadPos_ + (tailIrOffset_ - tailPartitionSize_)) % tailRingSize_;
+
+  std::fill(tailMacBuffer_.begin(), tailMacBuffer_.end(), 0.0f);
+  tailJobActive_ = true;
+}
+
+void ConvolutionEngine::tailJobStep(
+  const std::vector<std::vector<float>>& inputFFT)
+{
+  if (!tailJobActive_)
+    return;
+
+  if (tailJobSegmentsDone_ < numTailSegments_) {
+    // one budgeted slice of the MAC sweep; IR segment order matches the
+    // old single-block loop, so accumulation (and rounding) is unchanged
+    size_t todo =
+      std::min(tailJobChunk_, numTailSegments_ - tailJobSegmentsDone_);
+    for (size_t n = 0; n < todo; ++n) {
+      convolutionProcessingAndAccumulate(
+        inputFFT[tailJobMacIndex_].data(),
+        activeIR_->tailSegments[tailJobSegmentsDone_].data(),
+        tailMacBuffer_.data(),
+        tailFftSize_);
+      tailJobMacIndex_ =
+        (tailJobMacIndex_ > 0) ? tailJobMacIndex_ - 1 : numTailSegments_ - 1;
+      ++tailJobSegmentsDone_;
+    }
+    return; // the inverse transform gets a block of its own
+  }
+
+  updateSymmetricFrequencyDomainData(tailMacBuffer_.data(), tailFftSize_);
+  tailFft_.performRealOnlyInverseTransform(tailMacBuffer_.data());
+
+  size_t writePos = tailJobWritePos_;
+  for (size_t i = 0; i < tailFftSize_; ++i) {
+    tailOutputRing_[writePos] += tailMacBuffer_[i];
+    writePos = (writePos + 1) % tailRingSize_;
+  }
+
+  tailJobActive_ = false;
+}
+
+void ConvolutionEngine::finishTailJob(
+  const std::vector<std::vector<float>>& inputFFT)
+{
+  while (tailJobActive_)
+    tailJobStep(inputFFT);
 }
 
-void ConvolutionEngine::prepareForConvolution(float* samples)
+void ConvolutionEngine::prepareForConvolution(float* samples, size_t fftSize)
 {
-  size_t halfSize = fftSize_ / 2;
+  size_t halfSize = fftSize / 2;
 
   for (size_t i = 0; i < halfSize; ++i)
     samples[i] = samples[i << 1];
@@ -154,15 +515,36 @@ void ConvolutionEngine::prepareForConvolution(float* samples)
   samples[halfSize] = 0.0f;
 
   for (size_t i = 1; i < halfSize; ++i)
-    samples[i + halfSize] = -samples[((fftSize_ - i) << 1) + 1];
+    samples[i + halfSize] = -samples[((fftSize - i) << 1) + 1];
 }
 
 void ConvolutionEngine::convolutionProcessingAndAccumulate(const float* input,
                                                            const float* impulse,
-                                                           float* output)
+                                                           float* output,
+                                                           size_t fftSize)
 {
-  size_t halfSize = fftSize_ / 2;
-
+  size_t halfSize = fftSize / 2;
+
+#if defined(__wasm_simd128__)
+  // prepareForConvolution stores reals in [0, halfSize) and imaginaries in
+  // [halfSize, fftSize), so the complex MAC becomes four 4-wide sweeps
+  for (size_t i = 0; i < halfSize; i += 4) {
+    v128_t inRe = wasm_v128_load(input + i);
+    v128_t inIm = wasm_v128_load(input + halfSize + i);
+    v128_t impRe = wasm_v128_load(impulse + i);
+    v128_t impIm = wasm_v128_load(impulse + halfSize + i);
+
+    v128_t outRe = wasm_v128_load(output + i);
+    outRe = wasm_f32x4_add(outRe, wasm_f32x4_mul(inRe, impRe));
+    outRe = wasm_f32x4_sub(outRe, wasm_f32x4_mul(inIm, impIm));
+    wasm_v128_store(output + i, outRe);
+
+    v128_t outIm = wasm_v128_load(output + halfSize + i);
+    outIm = wasm_f32x4_add(outIm, wasm_f32x4_mul(inRe, impIm));
+    outIm = wasm_f32x4_add(outIm, wasm_f32x4_mul(inIm, impRe));
+    wasm_v128_store(output + halfSize + i, outIm);
+  }
+#else
   for (size_t i = 0; i < halfSize; ++i) {
     output[i] += input[i] * impulse[i];
   }
@@ -176,24 +558,26 @@ void ConvolutionEngine::convolutionProcessingAndAccumulate(const float* input,
   for (size_t i = 0; i < halfSize; ++i) {
     output[halfSize + i] += input[halfSize + i] * impulse[i];
   }
+#endif
 
-  output[fftSize_] += input[fftSize_] * impulse[fftSize_];
+  output[fftSize] += input[fftSize] * impulse[fftSize];
 }
 
-void ConvolutionEngine::updateSymmetricFrequencyDomainData(float* samples)
+void ConvolutionEngine::updateSymmetricFrequencyDomainData(float* samples,
+                                                           size_t fftSize)
 {
-  size_t halfSize = fftSize_ / 2;
+  size_t halfSize = fftSize / 2;
 
   for (size_t i = 1; i < halfSize; ++i) {
-    samples[(fftSize_ - i) << 1] = samples[i];
-    samples[((fftSize_ - i) << 1) + 1] = -samples[halfSize + i];
+    samples[(fftSize - i) << 1] = samples[i];
+    samples[((fftSize - i) << 1) + 1] = -samples[halfSize + i];
   }
 
   samples[1] = 0.0f;
 
   for (size_t i = 1; i < halfSize; ++i) {
-    samples[i << 1] = samples[(fftSize_ - i) << 1];
-    samples[(i << 1) + 1] = -samples[((fftSize_ - i) << 1) + 1];
+    samples[i << 1] = samples[(fftSize - i) << 1];
+    samples[(i << 1) + 1] = -samples[((fftSize - i) << 1) + 1];
   }
 }
 
@@ -201,9 +585,11 @@ void ConvolutionEngine::updateSymmetricFrequencyDomainData(float* samples)
 
 void StereoConvolutionReverb::prepare(float sampleRate)
 {
+  sampleRate_ = sampleRate;
   leftEngine_.prepare(sampleRate);
   rightEngine_.prepare(sampleRate);
   dryBuffer_.resize(128 * 2);
+  irCache_.reserve(kPreparedIRBankCapacity);
 }
 
 void StereoConvolutionReverb::loadIR(const float* irData,
@@ -237,8 +623,14 @@ void StereoConvolutionReverb::process(float* left, float* right, int numSamples)
     dryBuffer_[numSamples + i] = right[i];
   }
 
-  leftEngine_.process(left, left, numSamples);
-  rightEngine_.process(right, right, numSamples);
+  if (monoInput_ && leftEngine_.irLoaded() && rightEngine_.irLoaded()) {
+    // identical input on both channels: one forward transform, two IR MACs
+    leftEngine_.process(left, left, numSamples);
+    rightEngine_.renderShared(leftEngine_, right, numSamples);
+  } else {
+    leftEngine_.process(left, left, numSamples);
+    rightEngine_.process(right, right, numSamples);
+  }
 
   for (int i = 0; i < numSamples; ++i) {
     left[i] = dryBuffer_[i] * dryLevel_ + left[i] * wetLevel_;
@@ -246,6 +638,109 @@ void StereoConvolutionReverb::process(float* left, float* right, int numSamples)
   }
 }
 
+size_t StereoConvolutionReverb::addPreparedIR(const float* irData,
+                                              size_t irLengthPerChannel,
+                                              int numChannels)
+{
+  return adoptPreparedIR(buildPreparedIR(irData, irLengthPerChannel,
+                                         numChannels));
+}
+
+std::unique_ptr<StereoConvolutionReverb::StereoPreparedIR>
+StereoConvolutionReverb::buildPreparedIR(const float* irData,
+                                         size_t irLengthPerChannel,
+                                         int numChannels) const
+{
+  // scratch engines so the transforms never share state with the live
+  // pair; every partition size is a compile-time constant, so the result
+  // is interchangeable
+  ConvolutionEngine scratchLeft;
+  ConvolutionEngine scratchRight;
+
+  // clamp to the capacity prepare() reserved, so adopting the result is
+  // allocation-free on the audio thread
+  irLengthPerChannel =
+    std::min(irLengthPerChannel, ConvolutionEngine::maxIRLength(sampleRate_));
+
+  auto prepared = std::make_unique<StereoPreparedIR>();
+
+  if (numChannels == 1) {
+    prepared->left = scratchLeft.prepareIR(irData, irLengthPerChannel);
+    prepared->right = scratchRight.prepareIR(irData, irLengthPerChannel);
+  } else {
+    std::vector<float> leftIR(irLengthPerChannel);
+    std::vector<float> rightIR(irLengthPerChannel);
+
+    for (size_t i = 0; i < irLengthPerChannel; ++i) {
+      leftIR[i] = irData[i * 2];
+      rightIR[i] = irData[i * 2 + 1];
+    }
+
+    prepared->left = scratchLeft.prepareIR(leftIR.data(), irLengthPerChannel);
+    prepared->right =
+      scratchRight.prepareIR(rightIR.data(), irLengthPerChannel);
+  }
+
+  return prepared;
+}
+
+size_t StereoConvolutionReverb::adoptPreparedIR(
+  std::unique_ptr<StereoPreparedIR> prepared)
+{
+  // no capacity work here: prepare() reserved the input-side state for
+  // the longest supported IR, and in async-loader builds this runs inside
+  // the render callback
+  irCache_.push_back(std::move(prepared));
+  return irCache_.size() - 1;
+}
+
+size_t StereoConvolutionReverb::addPreparedIRFile(const void* blob,
+                                                  size_t numBytes)
+{
+  if (blob == nullptr || numBytes < sizeof(PreparedIRFileHeader))
+    return SIZE_MAX;
+
+  PreparedIRFileHeader header;
+  std::memcpy(&header, blob, sizeof(header));
+
+  if (header.numChannels != 1 && header.numChannels != 2)
+    return SIZE_MAX;
+
+  size_t floatsPerChannel =
+    header.numHeadSegments * ConvolutionEngine::headFftSize() * 2 +
+    header.numTailSegments * ConvolutionEngine::tailFftSize() * 2;
+  if (numBytes !=
+      sizeof(header) + header.numChannels * floatsPerChannel * sizeof(float))
+    return SIZE_MAX;
+
+  const float* channelData = reinterpret_cast<const float*>(
+    static_cast<const char*>(blob) + sizeof(header));
+
+  auto prepared = std::make_unique<StereoPreparedIR>();
+  if (!leftEngine_.importPreparedIR(header, channelData, prepared->left))
+    return SIZE_MAX;
+
+  const float* rightData =
+    (header.numChannels == 2) ? channelData + floatsPerChannel : channelData;
+  if (!rightEngine_.importPreparedIR(header, rightData, prepared->right))
+    return SIZE_MAX;
+
+  leftEngine_.ensureCapacity(prepared->left);
+  rightEngine_.ensureCapacity(prepared->right);
+
+  irCache_.push_back(std::move(prepared));
+  return irCache_.size() - 1;
+}
+
+void StereoConvolutionReverb::selectPreparedIR(size_t index)
+{
+  if (index >= irCache_.size())
+    return;
+
+  leftEngine_.setPreparedIR(&irCache_[index]->left);
+  rightEngine_.setPreparedIR(&irCache_[index]->right);
+}
+
 void StereoConvolutionReverb::setMix(float wetLevel, float dryLevel)
 {
   wetLevel_ = wetLevel;
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "dsp_config.h"
+#include "ir_file.h"
+
 #include <algorithm>
+#include <bit>
 #include <cstring>
 #include <juce_dsp/juce_dsp.h>
+#include <memory>
 #include <vector>
 
 class ConvolutionEngine
@@ -10,53 +15,208 @@ class ConvolutionEngine
 public:
   ConvolutionEngine() = default;
 
+  // Frequency-domain IR segments, computed once at load time so switching
+  // IRs never re-runs forward transforms on the audio thread
+  struct PreparedIR
+  {
+    std::vector<std::vector<float>> headSegments;
+    std::vector<std::vector<float>> tailSegments;
+    size_t numSegments = 0;
+    size_t numTailSegments = 0;
+  };
+
   void prepare(float sampleRate);
   void loadIR(const float* irData, size_t irLength);
   void process(const float* input, float* output, int numSamples);
   void reset();
 
+  // Transform a raw IR into cacheable frequency-domain segments
+  PreparedIR prepareIR(const float* irData, size_t irLength);
+
+  // Fill `ir` by copying one channel of offline-prepared segment data
+  // (see ir_file.h); returns false if the blob geometry does not match
+  // this engine's partitioning
+  bool importPreparedIR(const PreparedIRFileHeader& header,
+                        const float* segmentData,
+                        PreparedIR& ir);
+
+  // Partitioning geometry, for the offline prepare tool
+  static constexpr size_t headFftSize() { return fftSize_; }
+  static constexpr size_t tailFftSize() { return tailFftSize_; }
+
+  // Longest IR supported at runtime. prepare() reserves the input-side
+  // state for this length up front, so adopting and selecting prepared
+  // IRs later never allocates on the audio thread (in async-loader builds
+  // adoption runs inside the render callback). Longer raw IRs are clamped
+  // at build time; longer KIR1 blobs are rejected.
+  static constexpr float kMaxIRSeconds = 5.0f;
+  static size_t maxIRLength(float sampleRate);
+
+  // Grow input-side state to fit an IR of this size (allocates; call at
+  // load time, never from the audio thread)
+  void ensureCapacity(const PreparedIR& ir);
+
+  // O(1): point the engine at an already-prepared IR and clear state
+  void setPreparedIR(const PreparedIR* ir);
+
+  // Render using another engine's input-side transforms instead of our own.
+  // inputEngine must have processed the identical input for this block
+  // first; both engines must run in lock step with same-length IRs. Saves
+  // the forward FFT and input bookkeeping for mono sources.
+  void renderShared(const ConvolutionEngine& inputEngine,
+                    float* output,
+                    int numSamples);
+
+  bool irLoaded() const { return irLoaded_; }
+
 private:
-  void prepareForConvolution(float* samples);
+  void prepareForConvolution(float* samples, size_t fftSize);
   void convolutionProcessingAndAccumulate(const float* input,
                                           const float* impulse,
-                                          float* output);
-  void updateSymmetricFrequencyDomainData(float* samples);
+                                          float* output,
+                                          size_t fftSize);
+  void updateSymmetricFrequencyDomainData(float* samples, size_t fftSize);
+
+  // Amortized tail schedule: completing an input partition starts a job
+  // (forward transform up front), tailJobStep() runs one budgeted slice of
+  // the MAC sweep per block and the inverse transform on its own block, so
+  // the per-block worst case no longer carries a whole partition's work
+  // tail partitions an IR of this length needs (the head count is fixed)
+  static size_t tailSegmentsFor(size_t irLength);
 
-  static constexpr int fftOrder_ = 9;
-  static constexpr size_t fftSize_ = 512;
-  static constexpr size_t blockSize_ = 128;
+  void startTailJob();
+  void startSharedTailJob(const ConvolutionEngine& inputEngine);
+  void beginTailJob();
+  void tailJobStep(const std::vector<std::vector<float>>& inputFFT);
+  void finishTailJob(const std::vector<std::vector<float>>& inputFFT);
+
+  // Head FDL sized from the render quantum: a 4x FFT gives the usual
+  // 3x-block segment hop (512/128 historically)
+  static constexpr size_t blockSize_ = kRenderBlockSize;
+  static constexpr size_t fftSize_ = 4 * blockSize_;
+  static constexpr int fftOrder_ = std::bit_width(fftSize_) - 1;
   static constexpr size_t segmentSize_ = fftSize_ - blockSize_;
 
+  // Non-uniform partitioning: only the head of the IR runs through the
+  // 512-point FDL above; the rest is convolved in large partitions with one
+  // FFT/MAC per tailPartitionSize_ samples instead of per block. The head
+  // must cover at least one tail partition so the first tail contribution is
+  // ready by the time its output is due.
+  // Denormal control: silent input is snapped to exact zero before the
+  // forward FFT, and the overlap buffer gets a flush pass at this cadence
+  // so a decaying tail cannot park denormals there (see denormal.h)
+  static constexpr size_t sanitizeIntervalBlocks_ = 32;
+
+  static constexpr int tailFftOrder_ = 12;
+  static constexpr size_t tailFftSize_ = 4096;
+  static constexpr size_t tailPartitionSize_ = tailFftSize_ / 2;
+  // Smallest head covering two tail partitions (11 * 384 = 4224 at a
+  // 128-frame quantum). Covering the second partition buys the amortized
+  // tail schedule a full partition period between a partition completing
+  // and its result coming due, at the price of a few extra small head MACs
+  // per block.
+  static constexpr size_t numHeadSegments_ =
+    (2 * tailPartitionSize_ + segmentSize_ - 1) / segmentSize_;
+  static constexpr size_t tailIrOffset_ = numHeadSegments_ * segmentSize_;
+  static constexpr size_t tailRingSize_ = tailFftSize_ * 2;
+
+  // MAC slices per job; the remaining two blocks of the partition period
+  // take the inverse transform and the next partition's forward transform
+  static constexpr size_t tailSpreadBlocks_ =
+    tailPartitionSize_ / blockSize_ - 2;
+  static_assert(tailSpreadBlocks_ >= 1,
+                "render quantum too large to spread the tail work");
+
   juce::dsp::FFT fft_{ fftOrder_ };
+  juce::dsp::FFT tailFft_{ tailFftOrder_ };
+
+  const PreparedIR* activeIR_ = nullptr;
+  PreparedIR ownedIR_; // backing storage for the plain loadIR path
 
-  std::vector<std::vector<float>> irSegmentsFFT_;
   std::vector<std::vector<float>> inputSegmentsFFT_;
   std::vector<float> inputBuffer_;
   std::vector<float> outputBuffer_;
   std::vector<float> overlapBuffer_;
   std::vector<float> tempBuffer_;
 
+  std::vector<std::vector<float>> tailInputFFT_;
+  std::vector<float> tailInputBuffer_;
+  std::vector<float> tailMacBuffer_;
+  std::vector<float> tailOutputRing_;
+
   float sampleRate_ = 44100.0f;
   size_t numSegments_ = 0;
   size_t numInputSegments_ = 0;
   size_t currentSegment_ = 0;
   size_t inputDataPos_ = 0;
+  size_t numTailSegments_ = 0;
+  size_t currentTailSegment_ = 0;
+  size_t tailInputPos_ = 0;
+  size_t tailReadPos_ = 0;
+
+  // tail job in flight (see tailJobStep)
+  bool tailJobActive_ = false;
+  size_t tailJobChunk_ = 0;        // MAC segments per slice
+  size_t tailJobSegmentsDone_ = 0; // doubles as the IR segment index
+  size_t tailJobMacIndex_ = 0;     // input partition the next MAC reads
+  size_t tailJobWritePos_ = 0;     // ring position captured at job start
+  size_t blocksUntilSanitize_ = sanitizeIntervalBlocks_;
   bool irLoaded_ = false;
 };
 
 class StereoConvolutionReverb
 {
 public:
+  struct StereoPreparedIR
+  {
+    ConvolutionEngine::PreparedIR left;
+    ConvolutionEngine::PreparedIR right;
+  };
+
   void prepare(float sampleRate);
   void loadIR(const float* irData, size_t irLengthPerChannel, int numChannels);
   void process(float* left, float* right, int numSamples);
   void setMix(float wetLevel, float dryLevel);
   void reset();
 
+  // When the source is mono (identical left/right, as with the kick+noise
+  // bus), the right engine reuses the left engine's forward transforms
+  void setMonoInput(bool mono) { monoInput_ = mono; }
+
+  // FFT the IR once and keep it; returns the cache index
+  size_t addPreparedIR(const float* irData,
+                       size_t irLengthPerChannel,
+                       int numChannels);
+
+  // The same transform work split in two for the async loader: build runs
+  // on scratch engines and touches no live state, so a worker thread can
+  // do it while process() is active; adopt installs the result and must
+  // run on the audio thread at a block boundary
+  std::unique_ptr<StereoPreparedIR> buildPreparedIR(const float* irData,
+                                                    size_t irLengthPerChannel,
+                                                    int numChannels) const;
+  size_t adoptPreparedIR(std::unique_ptr<StereoPreparedIR> prepared);
+
+  // Ingest an offline-prepared "KIR1" blob (ir_file.h): one copy, no
+  // FFTs. Returns the cache index, or SIZE_MAX if the blob is invalid
+  size_t addPreparedIRFile(const void* blob, size_t numBytes);
+
+  // O(1) swap onto a cached IR (no transforms, no allocation)
+  void selectPreparedIR(size_t index);
+
+  size_t numPreparedIRs() const { return irCache_.size(); }
+
 private:
+  // cache entries reserved in prepare(); a bank load past this only costs
+  // a small pointer-array regrow
+  static constexpr size_t kPreparedIRBankCapacity = 32;
+
   ConvolutionEngine leftEngine_;
   ConvolutionEngine rightEngine_;
+  std::vector<std::unique_ptr<StereoPreparedIR>> irCache_;
   std::vector<float> dryBuffer_;
+  float sampleRate_ = 44100.0f;
   float wetLevel_ = 0.3f;
   float dryLevel_ = 0.7f;
+  bool monoInput_ = false;
 };
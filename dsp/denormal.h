@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+// WASM exposes no flush-to-zero mode, and on several client CPUs denormal
+// arithmetic runs 10-50x slower than normal floats; envelopes, overlap
+// buffers and filter tails decay straight through the denormal range in
+// the silence between kicks, which is exactly where the CPU spikes were
+// reported. These helpers clamp such values to exact zero at block rate,
+// where a compare per state variable is noise next to the work it avoids.
+
+inline constexpr float kDenormalThreshold = 1.0e-20f;
+
+inline float
+flushDenormal(float x)
+{
+  return std::fabs(x) < kDenormalThreshold ? 0.0f : x;
+}
+
+inline void
+flushDenormals(float* data, size_t length)
+{
+  for (size_t i = 0; i < length; ++i)
+    data[i] = flushDenormal(data[i]);
+}
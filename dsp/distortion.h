@@ -1,19 +1,47 @@
 #pragma once
 
-#include <cmath>
-#include <functional>
-#include <juce_dsp/juce_dsp.h>
+#include <algorithm>
 
-class Distortion
+// Shaping curve as an inlineable kernel instead of the old type-erased
+// std::function waveshaper (an indirect call per sample, per channel).
+// The curve matches tanh(x * drive) + 0.1 x^2: tanh is replaced by its
+// 7/6 Pade approximant with the output clamped to [-1, 1] past the
+// saturation point, so the loop is straight-line arithmetic the
+// compiler can vectorize. Worst-case deviation from the exact curve is
+// about 1e-4 (below -80 dB).
+struct AsymTanhShaper
+{
+  static float shape(float x, float drive)
+  {
+    float t = std::clamp(x * drive, -5.0f, 5.0f);
+    float t2 = t * t;
+    float num = t * (135135.0f + t2 * (17325.0f + t2 * (378.0f + t2)));
+    float den =
+      135135.0f + t2 * (62370.0f + t2 * (3150.0f + t2 * 28.0f));
+    return std::clamp(num / den, -1.0f, 1.0f) + 0.1f * x * x;
+  }
+};
+
+template <typename Shaper>
+class BasicDistortion
 {
 public:
-  Distortion() = default;
+  BasicDistortion() = default;
 
-  void prepare(float sampleRate);
-  void process(float* left, float* right, int numSamples);
-  void setDrive(float drive);
+  void prepare(float sampleRate) { (void)sampleRate; }
+
+  void process(float* left, float* right, int numSamples)
+  {
+    for (int i = 0; i < numSamples; ++i)
+      left[i] = Shaper::shape(left[i], drive_);
+    for (int i = 0; i < numSamples; ++i)
+      right[i] = Shaper::shape(right[i], drive_);
+  }
+
+  void setDrive(float drive) { drive_ = drive; }
 
 private:
-  juce::dsp::WaveShaper<float, std::function<float(float)>> waveshaper_;
   float drive_ = 6.0f;
 };
+
+using Distortion = BasicDistortion<AsymTanhShaper>;
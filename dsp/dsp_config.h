@@ -0,0 +1,17 @@
+#pragma once
+
+// Render quantum, in frames. Historically 128 was hardcoded in every
+// module independently; this is now the single point of truth so builds
+// for Chrome's larger render quanta (256/512 halve or quarter the
+// per-callback fixed overhead) only change one number. Selected at
+// compile time via -DDSP_BLOCK_SIZE (see the BLOCK_SIZE cmake option);
+// derived sizes like the convolution partitioning scale with it.
+#ifndef DSP_BLOCK_SIZE
+#define DSP_BLOCK_SIZE 128
+#endif
+
+inline constexpr int kRenderBlockSize = DSP_BLOCK_SIZE;
+
+static_assert(kRenderBlockSize == 128 || kRenderBlockSize == 256 ||
+                kRenderBlockSize == 512,
+              "the worklet render quantum must be 128, 256 or 512");
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Sample-accurate transport schedule. The beat grid is anchored in absolute
+// frame time when looping starts and re-derived on tempo changes, so
+// triggers land on the exact scheduled sample instead of being quantized to
+// render-quantum boundaries. Events sit in a preallocated sorted ring:
+// fillTo() materializes every beat before a block's end frame (kick each
+// beat, noise every 16th, plus pending noise swaps), process() pops them
+// and splits its player runs at the offsets. Nothing here allocates or
+// branches beyond the ring walk, and the ring drains fully every block, so
+// a command applied at a block boundary always affects the very next beat.
+class EventScheduler
+{
+public:
+  enum class Type : uint8_t
+  {
+    kickTrigger,
+    noiseTrigger,
+  };
+
+  struct Event
+  {
+    uint64_t frame = 0;
+    Type type = Type::kickTrigger;
+  };
+
+  // Anchor the grid: beat 0 is `now` (the caller fires its triggers for it
+  // directly), the first scheduled beat lands one period later
+  void start(uint64_t now, int samplesPerBeat)
+  {
+    running_ = true;
+    period_ = samplesPerBeat;
+    lastBeatFrame_ = now;
+    nextBeatFrame_ = now + static_cast<uint64_t>(samplesPerBeat);
+    beatCount_ = 0;
+    pendingNoiseSwap_ = false;
+    head_ = tail_ = 0;
+  }
+
+  void stop()
+  {
+    running_ = false;
+    pendingNoiseSwap_ = false;
+    head_ = tail_ = 0;
+  }
+
+  // Tempo change: keep the phase of the grid, so the next beat falls one
+  // new period after the last one (immediately if that is already past)
+  void setPeriod(int samplesPerBeat, uint64_t now)
+  {
+    period_ = samplesPerBeat;
+    if (!running_)
+      return;
+    nextBeatFrame_ = lastBeatFrame_ + static_cast<uint64_t>(samplesPerBeat);
+    if (nextBeatFrame_ < now)
+      nextBeatFrame_ = now;
+  }
+
+  // Retrigger noise on the next beat and restart its 16-beat cycle there
+  // (a new noise sample was selected mid-loop)
+  void requestNoiseSwap() { pendingNoiseSwap_ = true; }
+
+  // Top the ring up with every beat before endFrame
+  void fillTo(uint64_t endFrame)
+  {
+    while (running_ && period_ > 0 && nextBeatFrame_ < endFrame &&
+           size() + 2 <= kCapacity) {
+      beatCount_++;
+      push({ nextBeatFrame_, Type::kickTrigger });
+      if (pendingNoiseSwap_) {
+        push({ nextBeatFrame_, Type::noiseTrigger });
+        beatCount_ = 0;
+        pendingNoiseSwap_ = false;
+      } else if (beatCount_ % kNoiseBeatPeriod == 0) {
+        push({ nextBeatFrame_, Type::noiseTrigger });
+      }
+      lastBeatFrame_ = nextBeatFrame_;
+      nextBeatFrame_ += static_cast<uint64_t>(period_);
+    }
+  }
+
+  // Pop the next event strictly before endFrame, in frame order
+  bool pop(uint64_t endFrame, Event& out)
+  {
+    if (head_ == tail_ || ring_[head_ % kCapacity].frame >= endFrame)
+      return false;
+    out = ring_[head_ % kCapacity];
+    head_++;
+    return true;
+  }
+
+private:
+  uint32_t size() const { return tail_ - head_; }
+
+  void push(Event event) { ring_[tail_++ % kCapacity] = event; }
+
+  static constexpr uint32_t kCapacity = 32;
+  static constexpr uint32_t kNoiseBeatPeriod = 16;
+
+  std::array<Event, kCapacity> ring_{};
+  uint32_t head_ = 0;
+  uint32_t tail_ = 0;
+
+  uint64_t lastBeatFrame_ = 0;
+  uint64_t nextBeatFrame_ = 0;
+  int period_ = 0;
+  uint32_t beatCount_ = 0;
+  bool running_ = false;
+  bool pendingNoiseSwap_ = false;
+};
@@ -1,116 +1,138 @@
 #include "fft.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
 #include <numbers>
 #include <vector>
 
+namespace {
+
+// per-size tables built once on first use: bit-reversal permutation,
+// forward/inverse twiddle factors, and a scratch buffer for ifftReal so
+// no call allocates after warm-up
+struct FFTTables
+{
+  std::vector<size_t> bitReverse;
+  std::vector<float> forwardTwiddles; // interleaved re/im, size/2 roots
+  std::vector<float> inverseTwiddles;
+  std::vector<float> scratch;
+};
+
+FFTTables&
+tablesFor(size_t size)
+{
+  static std::vector<std::unique_ptr<FFTTables>> cache; // indexed by log2(size)
+
+  size_t order = 0;
+  while ((size_t(1) << order) < size)
+    order++;
+
+  if (cache.size() <= order)
+    cache.resize(order + 1);
+
+  if (!cache[order]) {
+    auto tables = std::make_unique<FFTTables>();
+
+    // bit-reversal permutation over complex elements
+    tables->bitReverse.resize(size);
+    for (size_t i = 0, rev = 0; i < size; ++i) {
+      tables->bitReverse[i] = rev;
+      // increment rev in reversed-bit order
+      size_t bit = size >> 1;
+      while (bit > 0 && (rev & bit)) {
+        rev ^= bit;
+        bit >>= 1;
+      }
+      rev |= bit;
+    }
+
+    // roots of unity w_N^k for k < N/2; stages with smaller spans index
+    // these with a stride of N/span
+    tables->forwardTwiddles.resize(size);
+    tables->inverseTwiddles.resize(size);
+    for (size_t k = 0; k < size / 2; ++k) {
+      float theta = -2.0f * std::numbers::pi_v<float> * k / size;
+      tables->forwardTwiddles[2 * k] = std::cos(theta);
+      tables->forwardTwiddles[2 * k + 1] = std::sin(theta);
+      tables->inverseTwiddles[2 * k] = std::cos(theta);
+      tables->inverseTwiddles[2 * k + 1] = -std::sin(theta);
+    }
+
+    tables->scratch.resize(size * 2);
+    cache[order] = std::move(tables);
+  }
+
+  return *cache[order];
+}
+
+// iterative radix-2 butterfly pass over interleaved complex data, in place
 void
-fft(const float* input, float* output, size_t size)
+fftInPlace(float* data, size_t size, const FFTTables& tables, bool inverse)
 {
-  // base case when we are down to 1 sample
-  // just return the sample with no imaginary part
-  if (size == 1) {
-    output[0] = input[0];
-    output[1] = 0.0f;
-    return;
+  const float* twiddles =
+    inverse ? tables.inverseTwiddles.data() : tables.forwardTwiddles.data();
+
+  for (size_t i = 0; i < size; ++i) {
+    size_t j = tables.bitReverse[i];
+    if (i < j) {
+      std::swap(data[2 * i], data[2 * j]);
+      std::swap(data[2 * i + 1], data[2 * j + 1]);
+    }
   }
 
-  // split input into even and odd samples
-  std::vector<float> evenSamples(size / 2);
-  std::vector<float> oddSamples(size / 2);
-  size_t j = 0;
-  for (size_t i = 0; i < size; i += 2) {
-    evenSamples[j] = input[i];
-    oddSamples[j] = input[i + 1];
-    j++;
+  for (size_t span = 2; span <= size; span <<= 1) {
+    size_t stride = size / span;
+    for (size_t start = 0; start < size; start += span) {
+      for (size_t k = 0; k < span / 2; ++k) {
+        float wReal = twiddles[2 * k * stride];
+        float wImag = twiddles[2 * k * stride + 1];
+
+        size_t top = 2 * (start + k);
+        size_t bottom = 2 * (start + k + span / 2);
+
+        // y[k] = y_even[k] + w^k y_odd[k]
+        // y[k + N/2] = y_even[k] - w^k y_odd[k]
+        float tReal = data[bottom] * wReal - data[bottom + 1] * wImag;
+        float tImag = data[bottom] * wImag + data[bottom + 1] * wReal;
+        data[bottom] = data[top] - tReal;
+        data[bottom + 1] = data[top + 1] - tImag;
+        data[top] += tReal;
+        data[top + 1] += tImag;
+      }
+    }
   }
+}
+
+} // namespace
 
-  // recurse
-  std::vector<float> evenSpectra(size);
-  std::vector<float> oddSpectra(size);
-  fft(evenSamples.data(), evenSpectra.data(), size / 2);
-  fft(oddSamples.data(), oddSpectra.data(), size / 2);
-
-  // combine
-  for (size_t i = 0; i < size; i += 2) {
-    // get root of unity, call it w
-    size_t bin = i / 2;
-    float theta = -2.0f * std::numbers::pi_v<float> * bin / size;
-    float wReal = std::cos(theta);
-    float wImag = std::sin(theta);
-
-    // get even/odd real/imaginary pieces
-    float evenReal = evenSpectra[i];
-    float evenImag = evenSpectra[i + 1];
-    float oddReal = oddSpectra[i];
-    float oddImag = oddSpectra[i + 1];
-
-    // y[k] = y_even[k] + w^k y_odd[k]
-    // y[k + N/2] = y_even[k] - w^k y_odd[k]
-    output[i] = evenReal + wReal * oddReal - wImag * oddImag;
-    output[i + 1] = evenImag + wReal * oddImag + wImag * oddReal;
-    output[i + size] = evenReal - (wReal * oddReal - wImag * oddImag);
-    output[i + size + 1] = evenImag - (wReal * oddImag + wImag * oddReal);
+void
+fft(const float* input, float* output, size_t size)
+{
+  // real samples in, interleaved complex spectrum out
+  for (size_t i = 0; i < size; ++i) {
+    output[2 * i] = input[i];
+    output[2 * i + 1] = 0.0f;
   }
+  fftInPlace(output, size, tablesFor(size), false);
 }
 
 void
 ifftReal(const float* input, float* output, size_t size)
 {
-  std::vector<float> fullOutput(size * 2);
-  ifft(input, fullOutput.data(), size);
+  auto& tables = tablesFor(size);
+  std::copy(input, input + size * 2, tables.scratch.data());
+  fftInPlace(tables.scratch.data(), size, tables, true);
   for (size_t i = 0; i < size; i++)
-    output[i] = fullOutput[i * 2];
+    output[i] = tables.scratch[2 * i] / size;
 }
 
 void
 ifft(const float* input, float* output, size_t size)
 {
-  // base case when we are down to 1 frequency
-  // just return the input
-  if (size == 1) {
-    output[0] = input[0];
-    output[1] = input[1];
-    return;
-  }
+  std::copy(input, input + size * 2, output);
+  fftInPlace(output, size, tablesFor(size), true);
 
-  // split input into even and odd spectra
-  std::vector<float> evenSpectra(size);
-  std::vector<float> oddSpectra(size);
-  size_t j = 0;
-  for (size_t i = 0; i < size * 2; i += 4) {
-    evenSpectra[j] = input[i];
-    evenSpectra[j + 1] = input[i + 1];
-    oddSpectra[j] = input[i + 2];
-    oddSpectra[j + 1] = input[i + 3];
-    j += 2;
-  }
-
-  // recurse
-  std::vector<float> evenSamples(size);
-  std::vector<float> oddSamples(size);
-  ifft(evenSpectra.data(), evenSamples.data(), size / 2);
-  ifft(oddSpectra.data(), oddSamples.data(), size / 2);
-
-  // combine
-  for (size_t i = 0; i < size; i += 2) {
-    // get root of unity, call it w
-    size_t bin = i / 2;
-    float theta = 2.0f * std::numbers::pi_v<float> * bin / size;
-    float wReal = std::cos(theta);
-    float wImag = std::sin(theta);
-
-    // get even/odd real/imaginary pieces
-    float evenReal = evenSamples[i];
-    float evenImag = evenSamples[i + 1];
-    float oddReal = oddSamples[i];
-    float oddImag = oddSamples[i + 1];
-
-    // y[k] = y_even[k] + w^k y_odd[k]
-    // y[k + N/2] = y_even[k] - w^k y_odd[k]
-    // divide by 2 to normalize
-    output[i] = (evenReal + wReal * oddReal - wImag * oddImag) / 2.0f;
-    output[i + 1] = (evenImag + wReal * oddImag + wImag * oddReal) / 2.0f;
-    output[i + size] = (evenReal - (wReal * oddReal - wImag * oddImag)) / 2.0f;
-    output[i + size + 1] =
-      (evenImag - (wReal * oddImag + wImag * oddReal)) / 2.0f;
-  }
+  // normalize
+  for (size_t i = 0; i < size * 2; ++i)
+    output[i] /= size;
 }
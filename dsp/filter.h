@@ -1,5 +1,7 @@
 #pragma once
 
+#include "dsp_config.h"
+
 #include <juce_dsp/juce_dsp.h>
 
 class Filter
@@ -11,7 +13,9 @@ public:
 
   void prepare(float sampleRate)
   {
-    juce::dsp::ProcessSpec spec{ sampleRate, 128u, 2u };
+    juce::dsp::ProcessSpec spec{ sampleRate,
+                                 static_cast<juce::uint32>(kRenderBlockSize),
+                                 2u };
     filter_.prepare(spec);
   }
 
@@ -28,6 +32,13 @@ public:
     filter_.setCutoffFrequency(hz);
   }
 
+  // Per-sample form for callers that fuse filtering into another loop;
+  // identical output to process(), channel 0 = left, 1 = right
+  float processSample(int channel, float sample)
+  {
+    return filter_.processSample(channel, sample);
+  }
+
   void process(float* left, float* right, int numSamples)
   {
     float* channels[] = { left, right };
@@ -35,6 +46,14 @@ public:
       channels, 2, static_cast<size_t>(numSamples));
     juce::dsp::ProcessContextReplacing<float> context(block);
     filter_.process(context);
+    filter_.snapToZero();
+  }
+
+  // Denormal squash for the internal states; processSample callers must
+  // invoke this once per block themselves (process() does it already)
+  void snapToZero()
+  {
+    filter_.snapToZero();
   }
 
 private:
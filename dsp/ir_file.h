@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk format for offline-prepared IRs ("KIR1"): the frequency-domain
+// segments exactly as ConvolutionEngine keeps them after prepareIR (split
+// re/im layout from prepareForConvolution), so loading is a straight copy
+// with no client-side FFT work at startup.
+//
+// Layout:
+//   PreparedIRFileHeader
+//   per channel: numHeadSegments segments of fftSize * 2 floats,
+//                then numTailSegments segments of tailFftSize * 2 floats
+//
+// The header is 32 bytes and every segment is a power-of-two float count,
+// so all float data keeps 16-byte alignment relative to the blob start.
+// Files are produced by the dsp-prepare-ir tool (testing/prepare_ir.cpp).
+struct PreparedIRFileHeader
+{
+  char magic[4]; // "KIR1"
+  uint32_t version;
+  uint32_t sampleRate;
+  uint32_t numChannels; // 1 or 2
+  uint32_t fftSize;
+  uint32_t tailFftSize;
+  uint32_t numHeadSegments;
+  uint32_t numTailSegments;
+};
+
+static_assert(sizeof(PreparedIRFileHeader) == 32,
+              "float data must stay 16-byte aligned after the header");
+
+inline constexpr char kPreparedIRMagic[4] = { 'K', 'I', 'R', '1' };
+// v2: head lengthened to cover two tail partitions (amortized tail
+// schedule); v1 blobs have the old head count and must be re-prepared
+inline constexpr uint32_t kPreparedIRVersion = 2;
@@ -1,7 +1,25 @@
 #pragma once
 
-#include <juce_dsp/juce_dsp.h>
+#include "dsp_config.h"
 
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Purpose-built brick-wall limiter for the master bus, replacing
+// juce::dsp::Limiter's per-sample compressor machinery. One render quantum
+// of lookahead through a block-sized delay ring: the peak of the incoming
+// block is scanned 4-wide, and the delayed block plays out under a linear
+// gain ramp that reaches the required attenuation exactly when the loud
+// block starts, so the ceiling is never exceeded. The ramp, the delay
+// exchange and the limiter drive (what used to be the separate
+// masterLimiterGain_ loop in AudioEngine) all happen in one fused sweep —
+// the master chain runs unconditionally, so its fixed cost is the one that
+// matters.
 class Limiter
 {
 public:
@@ -9,21 +27,93 @@ public:
 
   void prepare(float sampleRate)
   {
-    juce::dsp::ProcessSpec spec{ sampleRate, 128u, 2u };
-    limiter_.prepare(spec);
-    limiter_.setThreshold(0.0f);  // 0 dB ceiling
-    limiter_.setRelease(10.0f);   // 10ms release
+    releaseCoeff_ = std::exp(-static_cast<float>(kRenderBlockSize) /
+                             (sampleRate * kReleaseSeconds));
+    currentGain_ = 1.0f;
+    delayedLimit_ = 1.0f;
+    delayedL_.fill(0.0f);
+    delayedR_.fill(0.0f);
   }
 
-  void process(float* left, float* right, int numSamples)
+  // Drive is applied on the way into the delay ring, so the scan sees the
+  // driven signal and the caller needs no pre-gain pass of its own
+  void process(float* left, float* right, int numSamples, float drive = 1.0f)
   {
-    float* channels[] = { left, right };
-    juce::dsp::AudioBlock<float> block(
-      channels, 2, static_cast<size_t>(numSamples));
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    limiter_.process(context);
+    // peak scan of the incoming block
+    float peak = 0.0f;
+    int i = 0;
+#if defined(__wasm_simd128__)
+    v128_t vpeak = wasm_f32x4_splat(0.0f);
+    for (; i + 4 <= numSamples; i += 4) {
+      v128_t l = wasm_f32x4_abs(wasm_v128_load(left + i));
+      v128_t r = wasm_f32x4_abs(wasm_v128_load(right + i));
+      vpeak = wasm_f32x4_pmax(vpeak, wasm_f32x4_pmax(l, r));
+    }
+    vpeak = wasm_f32x4_pmax(vpeak, wasm_i32x4_shuffle(vpeak, vpeak, 2, 3, 0, 1));
+    vpeak = wasm_f32x4_pmax(vpeak, wasm_i32x4_shuffle(vpeak, vpeak, 1, 0, 3, 2));
+    peak = wasm_f32x4_extract_lane(vpeak, 0);
+#endif
+    for (; i < numSamples; ++i)
+      peak = std::max({ peak, std::abs(left[i]), std::abs(right[i]) });
+    peak *= drive;
+
+    // Gain trajectory for the delayed block. Attack ramps down within the
+    // lookahead so the loud block starts fully attenuated; release rises
+    // toward the incoming block's limit but never above what the delayed
+    // block itself allows, which keeps the output under the ceiling at
+    // every sample.
+    float limitIn = peak > kCeiling ? kCeiling / peak : 1.0f;
+    float target = std::min(delayedLimit_, limitIn);
+    float endGain;
+    if (target < currentGain_)
+      endGain = target;
+    else
+      endGain = std::min(delayedLimit_,
+                         target + (currentGain_ - target) * releaseCoeff_);
+    float step = numSamples > 0 ? (endGain - currentGain_) / numSamples : 0.0f;
+
+    // fused sweep: delayed block out under the ramp, driven input in
+    int j = 0;
+#if defined(__wasm_simd128__)
+    v128_t vgain = wasm_f32x4_make(currentGain_,
+                                   currentGain_ + step,
+                                   currentGain_ + 2.0f * step,
+                                   currentGain_ + 3.0f * step);
+    v128_t vstep = wasm_f32x4_splat(4.0f * step);
+    v128_t vdrive = wasm_f32x4_splat(drive);
+    for (; j + 4 <= numSamples; j += 4) {
+      v128_t inL = wasm_f32x4_mul(wasm_v128_load(left + j), vdrive);
+      v128_t inR = wasm_f32x4_mul(wasm_v128_load(right + j), vdrive);
+      v128_t outL = wasm_v128_load(delayedL_.data() + j);
+      v128_t outR = wasm_v128_load(delayedR_.data() + j);
+      wasm_v128_store(delayedL_.data() + j, inL);
+      wasm_v128_store(delayedR_.data() + j, inR);
+      wasm_v128_store(left + j, wasm_f32x4_mul(outL, vgain));
+      wasm_v128_store(right + j, wasm_f32x4_mul(outR, vgain));
+      vgain = wasm_f32x4_add(vgain, vstep);
+    }
+#endif
+    for (; j < numSamples; ++j) {
+      float gain = currentGain_ + j * step;
+      float inL = left[j] * drive;
+      float inR = right[j] * drive;
+      left[j] = delayedL_[j] * gain;
+      right[j] = delayedR_[j] * gain;
+      delayedL_[j] = inL;
+      delayedR_[j] = inR;
+    }
+
+    currentGain_ = endGain;
+    delayedLimit_ = limitIn;
   }
 
 private:
-  juce::dsp::Limiter<float> limiter_;
+  static constexpr float kCeiling = 1.0f;       // 0 dB
+  static constexpr float kReleaseSeconds = 0.010f;
+
+  alignas(16) std::array<float, kRenderBlockSize> delayedL_{};
+  alignas(16) std::array<float, kRenderBlockSize> delayedR_{};
+  float currentGain_ = 1.0f;
+  float delayedLimit_ = 1.0f;
+  float releaseCoeff_ = 0.0f;
 };
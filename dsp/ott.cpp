@@ -1,5 +1,43 @@
 #include "ott.h"
 
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// dB <-> linear via fast log2/exp2 (exponent bits plus a rational
+// correction on the mantissa, from the "fastapprox" family). Absolute
+// error is ~1e-4, far below what the gain computer needs; this removes
+// the per-sample log10/pow that dominated the OTT profile.
+constexpr float kDbPerLog2 = 6.0205999f;    // 20 * log10(2)
+constexpr float kLog2PerDb = 1.0f / kDbPerLog2;
+
+inline float fastLog2(float x)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  uint32_t mantissaBits = (bits & 0x007fffffu) | 0x3f000000u;
+  float m; // mantissa remapped into [0.5, 1)
+  std::memcpy(&m, &mantissaBits, sizeof(m));
+  float y = static_cast<float>(bits) * 1.1920929e-7f;
+  return y - 124.22551499f - 1.498030302f * m - 1.72587999f / (0.3520887068f + m);
+}
+
+inline float fastExp2(float p)
+{
+  float offset = (p < 0.0f) ? 1.0f : 0.0f;
+  float clipped = (p < -126.0f) ? -126.0f : p;
+  float z = clipped - static_cast<float>(static_cast<int>(clipped)) + offset;
+  uint32_t bits = static_cast<uint32_t>(
+    (1 << 23) * (clipped + 121.2740575f + 27.7280233f / (4.84252568f - z) -
+                 1.49012907f * z));
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+} // namespace
+
 // --- BandCompressor ---
 
 BandCompressor::BandCompressor(float attackMs, float releaseMs,
@@ -27,33 +65,44 @@ void BandCompressor::process(float* left, float* right, int numSamples,
 {
   float effectiveDownRatio = 1.0f + amount * (downRatio_ - 1.0f);
   float effectiveUpRatio = 1.0f + amount * (upRatio_ - 1.0f);
+  float downSlope = 1.0f - 1.0f / effectiveDownRatio;
+  float upSlope = 1.0f - 1.0f / effectiveUpRatio;
 
+  // pass 1: advance the envelope followers (serial recurrence; the branch
+  // only selects the smoothing coefficient)
   for (int i = 0; i < numSamples; ++i) {
-    left[i] = processSample(left[i], envelopeL_,
-                             effectiveDownRatio, effectiveUpRatio);
-    right[i] = processSample(right[i], envelopeR_,
-                              effectiveDownRatio, effectiveUpRatio);
+    float levelL = std::abs(left[i]);
+    float coeffL = (levelL > envelopeL_) ? attackCoeff_ : releaseCoeff_;
+    envelopeL_ = coeffL * envelopeL_ + (1.0f - coeffL) * levelL;
+    envBufL_[i] = envelopeL_;
+
+    float levelR = std::abs(right[i]);
+    float coeffR = (levelR > envelopeR_) ? attackCoeff_ : releaseCoeff_;
+    envelopeR_ = coeffR * envelopeR_ + (1.0f - coeffR) * levelR;
+    envBufR_[i] = envelopeR_;
   }
-}
 
-float BandCompressor::processSample(float sample, float& envelope,
-                                    float downRatio, float upRatio)
-{
-  float level = std::abs(sample);
-  float coeff = (level > envelope) ? attackCoeff_ : releaseCoeff_;
-  envelope = coeff * envelope + (1.0f - coeff) * level;
+  // the followers decay geometrically toward zero and would otherwise sit
+  // in denormal range for the whole silence between kicks
+  envelopeL_ = flushDenormal(envelopeL_);
+  envelopeR_ = flushDenormal(envelopeR_);
 
-  float envelopeDb = 20.0f * std::log10(std::max(envelope, 1e-6f));
-
-  float gainDb = 0.0f;
-  if (envelopeDb > downThresholdDb_) {
-    gainDb = (1.0f - 1.0f / downRatio) * (downThresholdDb_ - envelopeDb);
-  } else if (envelopeDb < upThresholdDb_) {
-    gainDb = (1.0f - 1.0f / upRatio) * (upThresholdDb_ - envelopeDb);
+  // pass 2: branchless gain curve over the stored envelopes; the up and
+  // down regions are disjoint so both terms can always be accumulated
+  for (int i = 0; i < numSamples; ++i) {
+    float envDb =
+      kDbPerLog2 * fastLog2(std::max(envBufL_[i], 1e-6f));
+    float gainDb = downSlope * std::min(0.0f, downThresholdDb_ - envDb) +
+                   upSlope * std::max(0.0f, upThresholdDb_ - envDb);
+    left[i] *= fastExp2(gainDb * kLog2PerDb);
+  }
+  for (int i = 0; i < numSamples; ++i) {
+    float envDb =
+      kDbPerLog2 * fastLog2(std::max(envBufR_[i], 1e-6f));
+    float gainDb = downSlope * std::min(0.0f, downThresholdDb_ - envDb) +
+                   upSlope * std::max(0.0f, upThresholdDb_ - envDb);
+    right[i] *= fastExp2(gainDb * kLog2PerDb);
   }
-
-  float gain = std::pow(10.0f, gainDb / 20.0f);
-  return sample * gain;
 }
 
 // --- OTTCompressor ---
@@ -73,27 +122,7 @@ OTTCompressor::OTTCompressor(float knobRatioMultiplier,
 
 void OTTCompressor::prepare(float sampleRate)
 {
-  juce::dsp::ProcessSpec spec{ sampleRate, 128u, 2u };
-
-  lowCrossoverLP_.setCutoffFrequency(100.0f);
-  lowCrossoverLP_.setType(
-    juce::dsp::LinkwitzRileyFilter<float>::Type::lowpass);
-  lowCrossoverLP_.prepare(spec);
-
-  lowCrossoverHP_.setCutoffFrequency(100.0f);
-  lowCrossoverHP_.setType(
-    juce::dsp::LinkwitzRileyFilter<float>::Type::highpass);
-  lowCrossoverHP_.prepare(spec);
-
-  highCrossoverLP_.setCutoffFrequency(2500.0f);
-  highCrossoverLP_.setType(
-    juce::dsp::LinkwitzRileyFilter<float>::Type::lowpass);
-  highCrossoverLP_.prepare(spec);
-
-  highCrossoverHP_.setCutoffFrequency(2500.0f);
-  highCrossoverHP_.setType(
-    juce::dsp::LinkwitzRileyFilter<float>::Type::highpass);
-  highCrossoverHP_.prepare(spec);
+  crossover_.prepare(sampleRate, 100.0f, 2500.0f);
 
   lowComp_.prepare(sampleRate);
   midComp_.prepare(sampleRate);
@@ -102,21 +131,10 @@ void OTTCompressor::prepare(float sampleRate)
 
 void OTTCompressor::process(float* left, float* right, int numSamples)
 {
-  for (int i = 0; i < numSamples; ++i) {
-    float lowL = lowCrossoverLP_.processSample(0, left[i]);
-    float lowR = lowCrossoverLP_.processSample(1, right[i]);
-    float restL = lowCrossoverHP_.processSample(0, left[i]);
-    float restR = lowCrossoverHP_.processSample(1, right[i]);
-
-    float midL = highCrossoverLP_.processSample(0, restL);
-    float midR = highCrossoverLP_.processSample(1, restR);
-    float highL = highCrossoverHP_.processSample(0, restL);
-    float highR = highCrossoverHP_.processSample(1, restR);
-
-    lowBandL_[i] = lowL;   lowBandR_[i] = lowR;
-    midBandL_[i] = midL;   midBandR_[i] = midR;
-    highBandL_[i] = highL; highBandR_[i] = highR;
-  }
+  crossover_.split(left, lowBandL_.data(), midBandL_.data(),
+                   highBandL_.data(), numSamples, 0);
+  crossover_.split(right, lowBandR_.data(), midBandR_.data(),
+                   highBandR_.data(), numSamples, 1);
 
   lowComp_.process(lowBandL_.data(), lowBandR_.data(), numSamples, amount_);
   midComp_.process(midBandL_.data(), midBandR_.data(), numSamples, amount_);
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "denormal.h"
+#include "dsp_config.h"
+
 #include <array>
 #include <cmath>
-#include <juce_dsp/juce_dsp.h>
+#include <numbers>
 
 class BandCompressor
 {
@@ -15,9 +18,6 @@ public:
   void process(float* left, float* right, int numSamples, float amount);
 
 private:
-  float processSample(float sample, float& envelope,
-                      float downRatio, float upRatio);
-
   float attackMs_, releaseMs_;
   float downThresholdDb_, downRatio_;
   float upThresholdDb_, upRatio_;
@@ -25,6 +25,111 @@ private:
   float releaseCoeff_ = 0.0f;
   float envelopeL_ = 0.0f;
   float envelopeR_ = 0.0f;
+
+  // Per-block envelope trace; the gain curve is applied over these in a
+  // second, vectorizable pass
+  std::array<float, kRenderBlockSize> envBufL_{}, envBufR_{};
+};
+
+// Fused three-band Linkwitz-Riley crossover. The previous four separate
+// juce::dsp::LinkwitzRileyFilter instances cost eight state-variable
+// updates per sample; here each LR4 pair shares its first section (the
+// TPT state update is independent of which output is tapped), so the
+// full low/mid/high split is six updates in one traversal, writing all
+// three band buffers in a single sweep.
+class ThreeBandCrossover
+{
+public:
+  void prepare(float sampleRate, float lowCutoffHz, float highCutoffHz)
+  {
+    lowSplit_.setCutoff(lowCutoffHz, sampleRate);
+    lowPost_.setCutoff(lowCutoffHz, sampleRate);
+    restPost_.setCutoff(lowCutoffHz, sampleRate);
+    highSplit_.setCutoff(highCutoffHz, sampleRate);
+    midPost_.setCutoff(highCutoffHz, sampleRate);
+    highPost_.setCutoff(highCutoffHz, sampleRate);
+    reset();
+  }
+
+  void reset()
+  {
+    lowSplit_.reset();
+    lowPost_.reset();
+    restPost_.reset();
+    highSplit_.reset();
+    midPost_.reset();
+    highPost_.reset();
+  }
+
+  // One sweep over the input writing all three bands for one channel
+  void split(const float* input, float* low, float* mid, float* high,
+             int numSamples, int channel)
+  {
+    for (int i = 0; i < numSamples; ++i) {
+      float lowStage, restStage, discard;
+      lowSplit_.tick(channel, input[i], lowStage, restStage);
+      lowPost_.tick(channel, lowStage, low[i], discard);
+      float rest;
+      restPost_.tick(channel, restStage, discard, rest);
+
+      float midStage, highStage;
+      highSplit_.tick(channel, rest, midStage, highStage);
+      midPost_.tick(channel, midStage, mid[i], discard);
+      highPost_.tick(channel, highStage, discard, high[i]);
+    }
+
+    // the integrator states ring through denormal range after the input
+    // goes quiet; squash them once per block
+    lowSplit_.sanitize(channel);
+    lowPost_.sanitize(channel);
+    restPost_.sanitize(channel);
+    highSplit_.sanitize(channel);
+    midPost_.sanitize(channel);
+    highPost_.sanitize(channel);
+  }
+
+private:
+  // 2nd-order Butterworth TPT section producing low and high outputs
+  // from one state update; two in cascade form each LR4 slope
+  struct Section
+  {
+    static constexpr float kR2 = std::numbers::sqrt2_v<float>;
+
+    void setCutoff(float hz, float sampleRate)
+    {
+      g = std::tan(std::numbers::pi_v<float> * hz / sampleRate);
+      h = 1.0f / (1.0f + kR2 * g + g * g);
+    }
+
+    void reset() { s1[0] = s1[1] = s2[0] = s2[1] = 0.0f; }
+
+    void sanitize(int ch)
+    {
+      s1[ch] = flushDenormal(s1[ch]);
+      s2[ch] = flushDenormal(s2[ch]);
+    }
+
+    void tick(int ch, float x, float& yLow, float& yHigh)
+    {
+      yHigh = (x - (kR2 + g) * s1[ch] - s2[ch]) * h;
+      float yBand = g * yHigh + s1[ch];
+      s1[ch] = g * yHigh + yBand;
+      yLow = g * yBand + s2[ch];
+      s2[ch] = g * yBand + yLow;
+    }
+
+    float g = 0.0f;
+    float h = 0.0f;
+    float s1[2] = { 0.0f, 0.0f };
+    float s2[2] = { 0.0f, 0.0f };
+  };
+
+  Section lowSplit_;  // shared first stage at the low crossover
+  Section lowPost_;   // second LP stage -> low band
+  Section restPost_;  // second HP stage -> mid+high bus
+  Section highSplit_; // shared first stage at the high crossover
+  Section midPost_;   // second LP stage -> mid band
+  Section highPost_;  // second HP stage -> high band
 };
 
 class OTTCompressor
@@ -42,18 +147,15 @@ public:
   void setAmount(float amount);
 
 private:
-  juce::dsp::LinkwitzRileyFilter<float> lowCrossoverLP_;
-  juce::dsp::LinkwitzRileyFilter<float> lowCrossoverHP_;
-  juce::dsp::LinkwitzRileyFilter<float> highCrossoverLP_;
-  juce::dsp::LinkwitzRileyFilter<float> highCrossoverHP_;
+  ThreeBandCrossover crossover_;
 
   BandCompressor lowComp_;
   BandCompressor midComp_;
   BandCompressor highComp_;
 
-  std::array<float, 128> lowBandL_{}, lowBandR_{};
-  std::array<float, 128> midBandL_{}, midBandR_{};
-  std::array<float, 128> highBandL_{}, highBandR_{};
+  std::array<float, kRenderBlockSize> lowBandL_{}, lowBandR_{};
+  std::array<float, kRenderBlockSize> midBandL_{}, midBandR_{};
+  std::array<float, kRenderBlockSize> highBandL_{}, highBandR_{};
 
   float amount_ = 0.0f;
   float knobLowBoost_;
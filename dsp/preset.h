@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+// Binary engine snapshot ("KPS1"): every sound-design parameter in the
+// units the setters take (volumes in dB, filters in Hz) plus the asset
+// cache indices, so the frontend restores a preset with one applyPreset
+// call instead of replaying ~20 embind setters. Transport state (BPM,
+// looping, cue) is performance state and deliberately not part of a
+// preset. The defaults below are the engine's own initial values, so a
+// default-constructed preset restores a freshly prepared engine.
+//
+// All fields are 4 bytes, so the struct is packed as written and safe to
+// copy through a HEAPU8 view.
+inline constexpr char kEnginePresetMagic[4] = { 'K', 'P', 'S', '1' };
+inline constexpr uint32_t kEnginePresetVersion = 1;
+inline constexpr int kPresetKickVoices = 4; // mirrors kNumKickVoices
+
+struct EnginePreset
+{
+  char magic[4] = { 'K', 'P', 'S', '1' };
+  uint32_t version = kEnginePresetVersion;
+
+  // sample bank index per kick voice, -1 mutes the voice
+  int32_t kickVoiceSample[kPresetKickVoices] = { 0, -1, -1, -1 };
+  float kickVoiceVolumeDb[kPresetKickVoices] = { 0.0f, 0.0f, 0.0f, 0.0f };
+  float kickLength = 1.0f;
+  float kickDistortion = 0.0f;
+  float kickOTT = 0.0f;
+
+  int32_t noiseSample = 0;
+  float noiseVolumeDb = 0.0f;
+  float noiseLowPassHz = 7000.0f;
+  float noiseHighPassHz = 30.0f;
+
+  int32_t irIndex = -1; // prepared-IR cache index, -1 = reverb off
+  float reverbLowPassHz = 7000.0f;
+  float reverbHighPassHz = 30.0f;
+  float reverbVolumeDb = 0.0f;
+
+  float masterOTT = 0.0f;
+  float masterDistortion = 0.0f;
+  float masterLimiter = 1.0f;
+};
+
+static_assert(sizeof(EnginePreset) == 96, "preset layout must stay packed");
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+// Load-time sample-rate conversion. Assets ship at 44.1 kHz but the
+// browser picks the AudioContext rate, so without this kicks play
+// detuned at 48 kHz; converting once at load keeps the playback loop a
+// straight sequential read with zero steady-state cost. Windowed-sinc
+// interpolation, evaluated directly at each output position (the
+// polyphase filter with one phase per output sample); 64 taps under a
+// Blackman window give a ~-74 dB stopband, plenty below the sample
+// material's own noise floor. The cutoff tracks the lower of the two
+// rates so downsampling stays anti-aliased.
+inline std::vector<float>
+resampleWindowedSinc(const float* input,
+                     size_t numInput,
+                     float sourceRate,
+                     float targetRate)
+{
+  if (numInput == 0 || sourceRate <= 0.0f || targetRate <= 0.0f ||
+      sourceRate == targetRate)
+    return { input, input + numInput };
+
+  constexpr int kHalfTaps = 32;
+  constexpr double pi = std::numbers::pi;
+
+  double ratio = static_cast<double>(targetRate) / sourceRate;
+  double cutoff = std::min(1.0, ratio);
+  size_t numOutput = static_cast<size_t>(numInput * ratio);
+
+  std::vector<float> output(numOutput);
+  for (size_t n = 0; n < numOutput; ++n) {
+    double center = n / ratio;
+    long first = static_cast<long>(std::ceil(center)) - kHalfTaps;
+    double acc = 0.0;
+    for (long k = first; k < first + 2 * kHalfTaps; ++k) {
+      if (k < 0 || k >= static_cast<long>(numInput))
+        continue;
+      double t = (k - center) * cutoff;
+      double sinc = t == 0.0 ? 1.0 : std::sin(pi * t) / (pi * t);
+      double u = (k - center) / kHalfTaps; // in (-1, 1]
+      double window =
+        0.42 + 0.5 * std::cos(pi * u) + 0.08 * std::cos(2.0 * pi * u);
+      acc += input[k] * sinc * window;
+    }
+    output[n] = static_cast<float>(acc * cutoff);
+  }
+  return output;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Bump allocator for sample and IR PCM. Everything lives in one slab so a
+// preset bank loads without the per-vector heap growth that fragments the
+// WASM heap and stalls the worklet under ALLOW_MEMORY_GROWTH; reserve() up
+// front makes loading allocation-free. Allocations start at 16-byte
+// offsets so SIMD loads on sample data stay aligned. Spans are offsets,
+// not pointers. The reservation is a hard cap: growing the slab would
+// reallocate it under the audio thread, which reads playing samples
+// through data() while the async loader adds to the pool. Eviction is
+// whole-slab: the app swaps preset banks wholesale, so the policy is
+// clear() and reload.
+class SampleArena
+{
+public:
+  struct Span
+  {
+    size_t offset = 0;
+    size_t length = 0; // in floats
+  };
+
+  void reserve(size_t numFloats)
+  {
+    if (numFloats > slab_.size())
+      slab_.resize(numFloats);
+  }
+
+  // Copies length floats into the slab and returns their span. When the
+  // reservation cannot fit the data the load fails with an empty span --
+  // never grown, see the class comment.
+  Span add(const float* src, size_t length)
+  {
+    size_t offset = (used_ + kAlignFloats - 1) & ~(kAlignFloats - 1);
+    if (offset + length > slab_.size())
+      return {};
+    std::copy_n(src, length, slab_.data() + offset);
+    used_ = offset + length;
+    return { offset, length };
+  }
+
+  const float* data(Span span) const { return slab_.data() + span.offset; }
+
+  void clear() { used_ = 0; }
+
+  size_t used() const { return used_; }
+  size_t capacity() const { return slab_.size(); }
+
+private:
+  static constexpr size_t kAlignFloats = 4; // 16 bytes
+
+  std::vector<float> slab_;
+  size_t used_ = 0;
+};
@@ -1,11 +1,34 @@
 #include "sample_player.h"
+#include "resample.h"
 #include <algorithm>
 #include <cstring>
 
-void SamplePlayer::loadSample(uintptr_t ptr, size_t length)
+void SamplePlayer::setArena(SampleArena* arena)
+{
+    arena_ = arena;
+}
+
+void SamplePlayer::loadSample(uintptr_t ptr, size_t length, float sourceRate)
 {
     const float* data = reinterpret_cast<const float*>(ptr);
-    samples_.emplace_back(data, data + length);
+    if (sourceRate > 0.0f && sourceRate != sampleRate_) {
+        std::vector<float> converted =
+            resampleWindowedSinc(data, length, sourceRate, sampleRate_);
+        reserveLocal(converted.size());
+        addSampleSpan(arena().add(converted.data(), converted.size()));
+    } else {
+        reserveLocal(length);
+        addSampleSpan(arena().add(data, length));
+    }
+}
+
+void SamplePlayer::addSampleSpan(SampleArena::Span span)
+{
+    // an empty span is a load the arena rejected (reservation exhausted);
+    // adding it would shift the bank indices by a silent slot
+    if (span.length == 0)
+        return;
+    samples_.push_back(span);
 }
 
 void SamplePlayer::selectSample(int index)
@@ -19,6 +42,17 @@ void SamplePlayer::selectSample(int index)
     }
 }
 
+void SamplePlayer::clearSamples()
+{
+    samples_.clear();
+    localArena_.clear();
+    activeSampleIndex_ = 0;
+    position_ = 0;
+    playing_ = false;
+    releasing_ = false;
+    envelopeLevel_ = 1.0f;
+}
+
 void SamplePlayer::trigger()
 {
     position_ = 0;
@@ -50,54 +84,97 @@ void SamplePlayer::process(float* left, float* right, int numSamples)
         return;
     }
 
-    const auto& sample = samples_[activeSampleIndex_];
+    const SampleArena::Span sample = samples_[activeSampleIndex_];
 
     // Calculate endpoint based on lengthRatio_
-    size_t endPosition = static_cast<size_t>(sample.size() * lengthRatio_);
+    size_t endPosition = static_cast<size_t>(sample.length * lengthRatio_);
     size_t fadeStartPosition = endPosition > kFadeOutSamples
         ? endPosition - kFadeOutSamples
         : 0;
 
-    for (int i = 0; i < numSamples; ++i) {
-        float output = 0.0f;
-
-        if (playing_) {
-            if (position_ >= endPosition) {
-                if (looping_) {
-                    position_ = 0;
-                } else {
-                    playing_ = false;
-                    releasing_ = false;
-                }
+    // Block-structured: split the block into runs inside which no state
+    // changes, so steady-state playback is a branch-free copy with the
+    // volume applied and fade/release become sub-block ramps
+    int i = 0;
+    while (i < numSamples && playing_) {
+        if (position_ >= endPosition) {
+            if (!looping_) {
+                playing_ = false;
+                releasing_ = false;
+                break;
             }
+            position_ = 0;
+            if (endPosition == 0)
+                break; // degenerate zero-length sample; stay armed
+        }
+
+        // Longest run with no event: stops at the block end, the sample
+        // end, the fade-out boundary, or where the release hits zero
+        size_t run = std::min(static_cast<size_t>(numSamples - i),
+                              endPosition - position_);
+        bool fading = !looping_ && position_ >= fadeStartPosition;
+        if (!looping_ && !fading)
+            run = std::min(run, fadeStartPosition - position_);
+        if (releasing_ && envelopeDecrement_ > 0.0f) {
+            size_t releaseLeft = static_cast<size_t>(
+                envelopeLevel_ / envelopeDecrement_) + 1;
+            run = std::min(run, releaseLeft);
+        }
 
-            if (playing_ && position_ < endPosition) {
-                output = sample[position_] * volume_;
+        const float* src = arena().data(sample) + position_;
+        float* dstL = left + i;
+        float* dstR = right + i;
 
-                // Apply fade-out as we approach the end position
-                if (position_ >= fadeStartPosition && !looping_) {
-                    float fadeProgress = static_cast<float>(position_ - fadeStartPosition)
+        if (!fading && !releasing_) {
+            // Steady state: straight copy with the volume applied
+            for (size_t n = 0; n < run; ++n) {
+                float output = src[n] * volume_;
+                dstL[n] = output;
+                dstR[n] = output;
+            }
+        } else {
+            // Ramp parameters computed once; the loop is multiply-only
+            float fadeGain = 1.0f;
+            float fadeStep = 0.0f;
+            if (fading) {
+                fadeGain = 1.0f
+                    - static_cast<float>(position_ - fadeStartPosition)
                         / static_cast<float>(kFadeOutSamples);
-                    output *= (1.0f - fadeProgress);
-                }
+                fadeStep = -1.0f / static_cast<float>(kFadeOutSamples);
+            }
 
-                if (releasing_) {
-                    output *= envelopeLevel_;
-                    envelopeLevel_ -= envelopeDecrement_;
+            float envGain = 1.0f;
+            float envStep = 0.0f;
+            if (releasing_) {
+                envGain = envelopeLevel_;
+                envStep = -envelopeDecrement_;
+            }
 
-                    if (envelopeLevel_ <= 0.0f) {
-                        envelopeLevel_ = 0.0f;
-                        playing_ = false;
-                        releasing_ = false;
-                    }
-                }
+            for (size_t n = 0; n < run; ++n) {
+                float output = src[n] * volume_ * fadeGain * envGain;
+                dstL[n] = output;
+                dstR[n] = output;
+                fadeGain += fadeStep;
+                envGain += envStep;
+            }
 
-                ++position_;
+            if (releasing_) {
+                envelopeLevel_ = envGain;
+                if (envelopeLevel_ <= 0.0f) {
+                    envelopeLevel_ = 0.0f;
+                    playing_ = false;
+                    releasing_ = false;
+                }
             }
         }
 
-        left[i] = output;
-        right[i] = output;
+        position_ += run;
+        i += run;
+    }
+
+    if (i < numSamples) {
+        std::memset(left + i, 0, sizeof(float) * (numSamples - i));
+        std::memset(right + i, 0, sizeof(float) * (numSamples - i));
     }
 }
 
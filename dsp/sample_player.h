@@ -1,5 +1,7 @@
 #pragma once
 
+#include "sample_arena.h"
+
 #include <vector>
 #include <cstddef>
 #include <cstdint>
@@ -9,12 +11,28 @@ class SamplePlayer
 public:
     SamplePlayer() = default;
 
-    // Copies Float32Array data from WASM heap into internal storage
-    void loadSample(uintptr_t ptr, size_t length);
+    // Samples from every player on an engine share one preallocated arena
+    // slab; a player without an attached arena falls back to a private one.
+    // Call before loading.
+    void setArena(SampleArena* arena);
+
+    // Copies Float32Array data from WASM heap into the arena. A non-zero
+    // sourceRate converts the data to the playback rate once here, so the
+    // process loop never interpolates; 0 means already at the playback
+    // rate. Call setSampleRate first.
+    void loadSample(uintptr_t ptr, size_t length, float sourceRate = 0.0f);
+
+    // Reference a sample another player already placed in the shared
+    // arena, without copying the PCM again (kick voices share one bank)
+    void addSampleSpan(SampleArena::Span span);
 
     // Switch active sample buffer (resets playback position)
     void selectSample(int index);
 
+    // Drop every loaded sample; the caller reclaims the arena. Like the
+    // load functions, call with playback stopped.
+    void clearSamples();
+
     // Reset playback to position 0
     void trigger();
 
@@ -24,6 +42,8 @@ public:
     // Read from active sample, apply volume and fade envelope
     void process(float* left, float* right, int numSamples);
 
+    bool isPlaying() const { return playing_; }
+
     void setReleaseDuration(float seconds);
     void setVolume(float gainLinear);
     void setSampleRate(float sampleRate);
@@ -31,9 +51,22 @@ public:
     void setLengthRatio(float ratio);
 
 private:
+    SampleArena& arena() { return arena_ ? *arena_ : localArena_; }
+
+    // A shared arena's reservation is its owner's contract and is never
+    // grown here (the audio thread may be reading it), but the private
+    // fallback has no concurrent reader and can grow to fit each load.
+    void reserveLocal(size_t numFloats)
+    {
+        if (arena_ == nullptr)
+            localArena_.reserve(localArena_.used() + numFloats + 16);
+    }
+
     float sampleRate_ = 44100.0f;
 
-    std::vector<std::vector<float>> samples_;
+    SampleArena* arena_ = nullptr;
+    SampleArena localArena_;
+    std::vector<SampleArena::Span> samples_;
     int activeSampleIndex_ = 0;
     size_t position_ = 0;
     bool playing_ = false;
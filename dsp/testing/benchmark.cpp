@@ -0,0 +1,163 @@
+// Per-stage benchmark for the DSP chain. Builds natively (for profiling on
+// the host) and under Emscripten/Node (for numbers representative of the
+// worklet). Reports ns per 128-sample block and percent of the real-time
+// budget for one render quantum.
+//
+// native:  cmake --build build --target dsp-benchmark && ./build/dsp-benchmark
+// wasm:    emcmake cmake ... && node dsp-benchmark.js
+
+#include "../audio_engine.h"
+#include "../convolution.h"
+#include "../distortion.h"
+#include "../ott.h"
+#include "../sample_player.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int kBlockSize = kRenderBlockSize;
+constexpr float kSampleRate = 44100.0f;
+constexpr double kBudgetNs = kBlockSize / double(kSampleRate) * 1e9; // ~2.9ms
+constexpr int kWarmupBlocks = 64;
+constexpr int kTimedBlocks = 2000;
+
+std::vector<float>
+makeNoise(size_t length, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+  std::vector<float> buffer(length);
+  for (auto& sample : buffer)
+    sample = dist(rng);
+  return buffer;
+}
+
+// run fn once per block, return average ns/block over the timed window
+template <typename Fn>
+double
+benchBlocks(Fn&& fn)
+{
+  for (int i = 0; i < kWarmupBlocks; ++i)
+    fn();
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kTimedBlocks; ++i)
+    fn();
+  auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         kTimedBlocks;
+}
+
+void
+report(const char* stage, double nsPerBlock)
+{
+  std::printf("%-44s %12.0f %9.2f%%\n",
+              stage,
+              nsPerBlock,
+              nsPerBlock / kBudgetNs * 100.0);
+}
+
+} // namespace
+
+int
+main()
+{
+  std::vector<float> left(kBlockSize), right(kBlockSize);
+  auto input = makeNoise(kBlockSize, 1);
+
+  std::printf("%-44s %12s %10s\n", "stage", "ns/block", "budget");
+
+  // SamplePlayer
+  {
+    SamplePlayer player;
+    auto sample = makeNoise(size_t(kSampleRate), 2);
+    player.setSampleRate(kSampleRate);
+    player.loadSample(reinterpret_cast<uintptr_t>(sample.data()),
+                      sample.size());
+    player.setLooping(true);
+    player.trigger();
+    report("SamplePlayer::process", benchBlocks([&] {
+             player.process(left.data(), right.data(), kBlockSize);
+           }));
+  }
+
+  // Distortion
+  {
+    Distortion distortion;
+    distortion.prepare(kSampleRate);
+    report("Distortion::process", benchBlocks([&] {
+             std::copy(input.begin(), input.end(), left.begin());
+             std::copy(input.begin(), input.end(), right.begin());
+             distortion.process(left.data(), right.data(), kBlockSize);
+           }));
+  }
+
+  // OTT
+  {
+    OTTCompressor ott;
+    ott.prepare(kSampleRate);
+    ott.setAmount(0.5f);
+    report("OTTCompressor::process", benchBlocks([&] {
+             std::copy(input.begin(), input.end(), left.begin());
+             std::copy(input.begin(), input.end(), right.begin());
+             ott.process(left.data(), right.data(), kBlockSize);
+           }));
+  }
+
+  // Convolution across IR lengths (0.1s / 1s / 3s)
+  for (size_t irLength : { size_t(kSampleRate) / 10,
+                           size_t(kSampleRate),
+                           size_t(kSampleRate) * 3 }) {
+    ConvolutionEngine engine;
+    engine.prepare(kSampleRate);
+    auto ir = makeNoise(irLength, 3);
+    engine.loadIR(ir.data(), ir.size());
+
+    char label[64];
+    std::snprintf(label,
+                  sizeof(label),
+                  "ConvolutionEngine::process (%.1fs IR)",
+                  irLength / double(kSampleRate));
+    report(label, benchBlocks([&] {
+             engine.process(input.data(), left.data(), kBlockSize);
+           }));
+  }
+
+  // Full engine
+  {
+    AudioEngine engine;
+    engine.prepare(kSampleRate);
+
+    auto kick = makeNoise(size_t(kSampleRate / 2), 4);
+    auto noise = makeNoise(size_t(kSampleRate), 5);
+    auto ir = makeNoise(size_t(kSampleRate) * 2, 6);
+
+    engine.loadKickSample(reinterpret_cast<uintptr_t>(kick.data()),
+                          kick.size());
+    engine.loadNoiseSample(reinterpret_cast<uintptr_t>(noise.data()),
+                           noise.size());
+    engine.loadIR(reinterpret_cast<uintptr_t>(ir.data()), ir.size() / 2, 2);
+    engine.selectKickSample(0);
+    engine.selectNoiseSample(0);
+    engine.selectIR(0);
+    engine.setKickDistortion(0.5f);
+    engine.setKickOTT(0.5f);
+    engine.setMasterOTT(0.5f);
+    engine.setMasterDistortion(0.5f);
+    engine.setLooping(true);
+
+    report("AudioEngine::process (full chain)", benchBlocks([&] {
+             engine.process(reinterpret_cast<uintptr_t>(left.data()),
+                            reinterpret_cast<uintptr_t>(right.data()),
+                            kBlockSize);
+           }));
+  }
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+// Offline IR preparation: run the forward transforms the client used to do
+// at startup and write the frequency-domain segments as a "KIR1" blob
+// (see ir_file.h) that AudioEngine::loadPreparedIR ingests with a straight
+// copy and zero FFT work.
+//
+//   cmake --build build --target dsp-prepare-ir
+//   ./build/dsp-prepare-ir ir.wav ir.kir
+
+#include "../convolution.h"
+#include "../ir_file.h"
+#include "wav_io.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+bool
+writeChannel(FILE* file, const ConvolutionEngine::PreparedIR& ir)
+{
+  for (const auto& segment : ir.headSegments)
+    if (std::fwrite(segment.data(), sizeof(float), segment.size(), file) !=
+        segment.size())
+      return false;
+  for (const auto& segment : ir.tailSegments)
+    if (std::fwrite(segment.data(), sizeof(float), segment.size(), file) !=
+        segment.size())
+      return false;
+  return true;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  if (argc != 3) {
+    std::fprintf(stderr, "usage: %s ir.wav out.kir\n", argv[0]);
+    return 1;
+  }
+
+  WavData wav;
+  if (!readWav(argv[1], wav))
+    return 1;
+  if (wav.numChannels != 1 && wav.numChannels != 2) {
+    std::fprintf(stderr, "%s: need 1 or 2 channels\n", argv[1]);
+    return 1;
+  }
+
+  ConvolutionEngine engine;
+  engine.prepare(float(wav.sampleRate));
+
+  std::vector<ConvolutionEngine::PreparedIR> channels(wav.numChannels);
+  if (wav.numChannels == 1) {
+    channels[0] = engine.prepareIR(wav.samples.data(), wav.numFrames());
+  } else {
+    std::vector<float> mono(wav.numFrames());
+    for (int ch = 0; ch < 2; ++ch) {
+      for (size_t i = 0; i < mono.size(); ++i)
+        mono[i] = wav.samples[i * 2 + ch];
+      channels[ch] = engine.prepareIR(mono.data(), mono.size());
+    }
+  }
+
+  PreparedIRFileHeader header{};
+  std::memcpy(header.magic, kPreparedIRMagic, 4);
+  header.version = kPreparedIRVersion;
+  header.sampleRate = wav.sampleRate;
+  header.numChannels = wav.numChannels;
+  header.fftSize = uint32_t(ConvolutionEngine::headFftSize());
+  header.tailFftSize = uint32_t(ConvolutionEngine::tailFftSize());
+  header.numHeadSegments = uint32_t(channels[0].numSegments);
+  header.numTailSegments = uint32_t(channels[0].numTailSegments);
+
+  FILE* out = std::fopen(argv[2], "wb");
+  if (out == nullptr) {
+    std::fprintf(stderr, "cannot write %s\n", argv[2]);
+    return 1;
+  }
+
+  bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+  for (const auto& channel : channels)
+    ok = ok && writeChannel(out, channel);
+  std::fclose(out);
+
+  if (!ok) {
+    std::fprintf(stderr, "write failed: %s\n", argv[2]);
+    return 1;
+  }
+
+  std::printf("%s: %zu frames x %u ch -> %u head + %u tail segments\n",
+              argv[1],
+              wav.numFrames(),
+              wav.numChannels,
+              header.numHeadSegments,
+              header.numTailSegments);
+  return 0;
+}
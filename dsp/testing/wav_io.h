@@ -0,0 +1,137 @@
+#pragma once
+
+// Minimal WAV reader/writer shared by the native tools. Handles mono or
+// stereo 16-bit PCM and 32-bit float input; output is 32-bit float.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct WavData
+{
+  std::vector<float> samples; // interleaved
+  uint16_t numChannels = 0;
+  uint32_t sampleRate = 0;
+
+  size_t numFrames() const
+  {
+    return numChannels > 0 ? samples.size() / numChannels : 0;
+  }
+};
+
+inline bool
+readWav(const char* path, WavData& wav)
+{
+  FILE* file = std::fopen(path, "rb");
+  if (file == nullptr) {
+    std::fprintf(stderr, "cannot open %s\n", path);
+    return false;
+  }
+
+  char riff[4], wave[4];
+  uint32_t riffSize = 0;
+  if (std::fread(riff, 1, 4, file) != 4 ||
+      std::fread(&riffSize, 4, 1, file) != 1 ||
+      std::fread(wave, 1, 4, file) != 4 || std::memcmp(riff, "RIFF", 4) != 0 ||
+      std::memcmp(wave, "WAVE", 4) != 0) {
+    std::fprintf(stderr, "%s is not a RIFF/WAVE file\n", path);
+    std::fclose(file);
+    return false;
+  }
+
+  uint16_t format = 0, bitsPerSample = 0;
+  bool haveFmt = false, haveData = false;
+
+  char chunkId[4];
+  uint32_t chunkSize = 0;
+  while (std::fread(chunkId, 1, 4, file) == 4 &&
+         std::fread(&chunkSize, 4, 1, file) == 1) {
+    if (std::memcmp(chunkId, "fmt ", 4) == 0) {
+      uint8_t fmt[16];
+      if (chunkSize < 16 || std::fread(fmt, 1, 16, file) != 16)
+        break;
+      std::memcpy(&format, fmt + 0, 2);
+      std::memcpy(&wav.numChannels, fmt + 2, 2);
+      std::memcpy(&wav.sampleRate, fmt + 4, 4);
+      std::memcpy(&bitsPerSample, fmt + 14, 2);
+      std::fseek(file, long(chunkSize - 16), SEEK_CUR);
+      haveFmt = true;
+    } else if (std::memcmp(chunkId, "data", 4) == 0 && haveFmt) {
+      if (format == 1 && bitsPerSample == 16) {
+        std::vector<int16_t> raw(chunkSize / 2);
+        if (std::fread(raw.data(), 2, raw.size(), file) != raw.size())
+          break;
+        wav.samples.resize(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i)
+          wav.samples[i] = raw[i] / 32768.0f;
+      } else if (format == 3 && bitsPerSample == 32) {
+        wav.samples.resize(chunkSize / 4);
+        if (std::fread(wav.samples.data(), 4, wav.samples.size(), file) !=
+            wav.samples.size())
+          break;
+      } else {
+        std::fprintf(stderr,
+                     "%s: unsupported format %u / %u bits (need 16-bit PCM "
+                     "or 32-bit float)\n",
+                     path,
+                     format,
+                     bitsPerSample);
+        std::fclose(file);
+        return false;
+      }
+      haveData = true;
+      break;
+    } else {
+      // skip unknown chunks (word-aligned)
+      std::fseek(file, long(chunkSize + (chunkSize & 1)), SEEK_CUR);
+    }
+  }
+
+  std::fclose(file);
+  if (!haveData)
+    std::fprintf(stderr, "%s: no usable data chunk\n", path);
+  return haveData;
+}
+
+inline bool
+writeWav(const char* path,
+         const std::vector<float>& left,
+         const std::vector<float>& right,
+         uint32_t sampleRate)
+{
+  FILE* file = std::fopen(path, "wb");
+  if (file == nullptr) {
+    std::fprintf(stderr, "cannot write %s\n", path);
+    return false;
+  }
+
+  uint32_t dataSize = uint32_t(left.size() * 2 * 4);
+  uint32_t riffSize = 36 + dataSize;
+  uint16_t format = 3, channels = 2, bits = 32;
+  uint32_t byteRate = sampleRate * channels * 4;
+  uint16_t blockAlign = channels * 4;
+  uint32_t fmtSize = 16;
+
+  std::fwrite("RIFF", 1, 4, file);
+  std::fwrite(&riffSize, 4, 1, file);
+  std::fwrite("WAVE", 1, 4, file);
+  std::fwrite("fmt ", 1, 4, file);
+  std::fwrite(&fmtSize, 4, 1, file);
+  std::fwrite(&format, 2, 1, file);
+  std::fwrite(&channels, 2, 1, file);
+  std::fwrite(&sampleRate, 4, 1, file);
+  std::fwrite(&byteRate, 4, 1, file);
+  std::fwrite(&blockAlign, 2, 1, file);
+  std::fwrite(&bits, 2, 1, file);
+  std::fwrite("data", 1, 4, file);
+  std::fwrite(&dataSize, 4, 1, file);
+
+  for (size_t i = 0; i < left.size(); ++i) {
+    std::fwrite(&left[i], 4, 1, file);
+    std::fwrite(&right[i], 4, 1, file);
+  }
+
+  std::fclose(file);
+  return true;
+}